@@ -1,254 +1,139 @@
 #include <iostream>
-#include <fstream>
+#include <memory>
 #include <string>
-#include <vector>
-#include <filesystem>
-#include <regex>
-#include <map>
-#include <iomanip>
+#include <thread>
+#include <algorithm>
+#include "CastAnalyzer.hpp"
+#include "ResultWriter.hpp"
 
-namespace fs = std::filesystem;
-
-struct CastOccurrence
-{
-    std::string castType;
-    std::string line;
-    size_t lineNumber;
-    std::string context; // Stores a few lines before and after the cast
-};
-
-struct FileAnalysis
+void printUsage(const char *program)
 {
-    std::vector<CastOccurrence> occurrences;
-};
+    std::cout << "Usage: " << program << " [--jobs N] [--cache FILE] [--format FORMAT] [--stats]\n"
+              << "          [--readers N] [--queue-depth N] [PATH]\n"
+              << "  -j, --jobs N        number of worker threads (default: hardware concurrency)\n"
+              << "  --cache FILE        reuse results for unchanged files from FILE and update it\n"
+              << "  --format FORMAT     scan PATH without the menu and stream the results to\n"
+              << "                      stdout as json, csv or sarif\n"
+              << "  --stats             print throughput, time per stage and peak memory after\n"
+              << "                      the scan (to stderr with --format)\n"
+              << "  --readers N         pipeline the scan: N threads open and prefetch files\n"
+              << "                      ahead of the matching workers (for network filesystems)\n"
+              << "  --queue-depth N     files buffered between pipeline stages (default: 64)\n"
+              << "Without --format, PATH is analyzed interactively (prompted for if omitted).\n";
+}
 
-class CastAnalyzer
+int main(int argc, char *argv[])
 {
-private:
-    std::map<std::string, FileAnalysis> fileResults;
-    std::vector<std::string> castTypes = {
-        "static_cast",
-        "dynamic_cast",
-        "const_cast",
-        "reinterpret_cast"};
-
-    bool isCppFile(const std::string &path)
-    {
-        std::string ext = fs::path(path).extension().string();
-        return ext == ".cpp" || ext == ".h" || ext == ".hpp";
-    }
-
-    std::string getContext(const std::vector<std::string> &lines, size_t castLine, size_t contextSize = 2)
-    {
-        std::string context;
-        size_t start = (castLine > contextSize) ? castLine - contextSize : 0;
-        size_t end = std::min(lines.size(), castLine + contextSize + 1);
-
-        for (size_t i = start; i < end; ++i)
-        {
-            context += std::to_string(i + 1) + ": " + lines[i] + "\n";
-        }
-        return context;
-    }
+    size_t jobs = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::string cachePath;
+    std::string format;
+    std::string dirPath;
+    bool showStats = false;
+    size_t readers = 0;
+    size_t queueDepth = 64;
 
-    void analyzeFile(const std::string &filepath)
+    for (int i = 1; i < argc; ++i)
     {
-        std::ifstream file(filepath);
-        if (!file.is_open())
-        {
-            std::cerr << "Failed to open file: " << filepath << std::endl;
-            return;
-        }
-
-        std::vector<std::string> lines;
-        std::string line;
-        while (std::getline(file, line))
-        {
-            lines.push_back(line);
-        }
-
-        FileAnalysis analysis;
-        for (size_t i = 0; i < lines.size(); ++i)
+        std::string arg = argv[i];
+        if ((arg == "-j" || arg == "--jobs") && i + 1 < argc)
         {
-            for (const auto &castType : castTypes)
+            try
             {
-                std::regex castPattern(castType + "\\s*<.*?>\\s*\\(");
-                if (std::regex_search(lines[i], castPattern))
-                {
-                    CastOccurrence occurrence;
-                    occurrence.castType = castType;
-                    occurrence.line = lines[i];
-                    occurrence.lineNumber = i + 1;
-                    occurrence.context = getContext(lines, i);
-                    analysis.occurrences.push_back(occurrence);
-                }
+                jobs = std::max<size_t>(1, std::stoul(argv[++i]));
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Invalid job count: " << argv[i] << std::endl;
+                return 1;
             }
         }
-
-        if (!analysis.occurrences.empty())
-        {
-            fileResults[filepath] = analysis;
-        }
-    }
-
-public:
-    void analyzePath(const std::string &path)
-    {
-        try
+        else if ((arg == "--readers" || arg == "--queue-depth") && i + 1 < argc)
         {
-            for (const auto &entry : fs::recursive_directory_iterator(path))
+            try
+            {
+                (arg == "--readers" ? readers : queueDepth) = std::stoul(argv[++i]);
+            }
+            catch (const std::exception &)
             {
-                if (entry.is_regular_file() && isCppFile(entry.path().string()))
-                {
-                    analyzeFile(entry.path().string());
-                }
+                std::cerr << "Invalid count for " << arg << ": " << argv[i] << std::endl;
+                return 1;
             }
         }
-        catch (const fs::filesystem_error &e)
+        else if (arg == "--cache" && i + 1 < argc)
         {
-            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            cachePath = argv[++i];
         }
-    }
-
-    void displayMenu()
-    {
-        while (true)
+        else if (arg == "--format" && i + 1 < argc)
         {
-            std::cout << "\n=== Cast Analyzer Menu ===\n";
-            std::cout << "1. Show summary of all files\n";
-            std::cout << "2. Show detailed analysis for a specific file\n";
-            std::cout << "3. Search by cast type\n";
-            std::cout << "4. Exit\n";
-            std::cout << "Enter your choice (1-4): ";
-
-            int choice;
-            std::cin >> choice;
-            std::cin.ignore();
-
-            switch (choice)
-            {
-            case 1:
-                showSummary();
-                break;
-            case 2:
-                showFileDetails();
-                break;
-            case 3:
-                searchByCastType();
-                break;
-            case 4:
-                return;
-            default:
-                std::cout << "Invalid choice. Please try again.\n";
-            }
+            format = argv[++i];
         }
-    }
-
-private:
-    void showSummary()
-    {
-        std::cout << "\n=== Summary of Cast Usage ===\n";
-        for (const auto &[file, analysis] : fileResults)
+        else if (arg.rfind("--format=", 0) == 0)
         {
-            std::cout << "\nFile: " << file << "\n";
-            std::cout << "Total casts found: " << analysis.occurrences.size() << "\n";
-
-            std::map<std::string, int> castCounts;
-            for (const auto &occ : analysis.occurrences)
-            {
-                castCounts[occ.castType]++;
-            }
-
-            for (const auto &[type, count] : castCounts)
-            {
-                std::cout << "  " << type << ": " << count << "\n";
-            }
+            format = arg.substr(9);
         }
-    }
-
-    void showFileDetails()
-    {
-        std::cout << "\nAvailable files:\n";
-        int index = 1;
-        std::vector<std::string> files;
-        for (const auto &[file, _] : fileResults)
+        else if (arg == "--stats")
         {
-            std::cout << index++ << ". " << file << "\n";
-            files.push_back(file);
+            showStats = true;
         }
-
-        std::cout << "Enter file number: ";
-        int fileChoice;
-        std::cin >> fileChoice;
-        std::cin.ignore();
-
-        if (fileChoice < 1 || fileChoice > files.size())
+        else if (arg == "-h" || arg == "--help")
         {
-            std::cout << "Invalid file number.\n";
-            return;
+            printUsage(argv[0]);
+            return 0;
         }
-
-        const auto &file = files[fileChoice - 1];
-        const auto &analysis = fileResults[file];
-
-        std::cout << "\nDetailed analysis for: " << file << "\n";
-        for (const auto &occ : analysis.occurrences)
+        else if (!arg.empty() && arg[0] != '-' && dirPath.empty())
         {
-            std::cout << "\n=== " << occ.castType << " at line " << occ.lineNumber << " ===\n";
-            std::cout << "Context:\n"
-                      << occ.context << "\n";
+            dirPath = arg;
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
         }
     }
 
-    void searchByCastType()
+    CastAnalyzer analyzer;
+    analyzer.setCachePath(cachePath);
+    analyzer.setPipeline(readers, queueDepth);
+
+    if (!format.empty())
     {
-        std::cout << "\nAvailable cast types:\n";
-        for (size_t i = 0; i < castTypes.size(); ++i)
+        std::unique_ptr<ResultWriter> writer = ResultWriter::create(format, std::cout, analyzer.getCastTypes());
+        if (!writer)
         {
-            std::cout << i + 1 << ". " << castTypes[i] << "\n";
+            std::cerr << "Unknown format: " << format << " (expected json, csv or sarif)" << std::endl;
+            return 1;
         }
-
-        std::cout << "Enter cast type number: ";
-        int typeChoice;
-        std::cin >> typeChoice;
-        std::cin.ignore();
-
-        if (typeChoice < 1 || typeChoice > castTypes.size())
+        if (dirPath.empty())
         {
-            std::cout << "Invalid cast type.\n";
-            return;
+            std::cerr << "--format requires a PATH to analyze" << std::endl;
+            return 1;
         }
 
-        const std::string &selectedType = castTypes[typeChoice - 1];
-        std::cout << "\nOccurrences of " << selectedType << ":\n";
-
-        for (const auto &[file, analysis] : fileResults)
+        analyzer.setResultWriter(writer.get());
+        writer->begin();
+        analyzer.analyzePath(dirPath, jobs);
+        writer->end();
+        if (showStats)
         {
-            for (const auto &occ : analysis.occurrences)
-            {
-                if (occ.castType == selectedType)
-                {
-                    std::cout << "\nFile: " << file << "\n";
-                    std::cout << "Line " << occ.lineNumber << ":\n";
-                    std::cout << occ.context << "\n";
-                }
-            }
+            analyzer.getStats().print(std::cerr);
         }
+        return 0;
     }
-};
 
-int main()
-{
     std::cout << "=== C++ Cast Analyzer ===\n";
-    std::cout << "Enter the directory path to analyze: ";
-
-    std::string dirPath;
-    std::getline(std::cin, dirPath);
-
-    CastAnalyzer analyzer;
+    if (dirPath.empty())
+    {
+        std::cout << "Enter the directory path to analyze: ";
+        std::getline(std::cin, dirPath);
+    }
 
     std::cout << "Analyzing files...\n";
-    analyzer.analyzePath(dirPath);
+    analyzer.analyzePath(dirPath, jobs);
+    if (showStats)
+    {
+        analyzer.getStats().print(std::cout);
+    }
 
     analyzer.displayMenu();
 
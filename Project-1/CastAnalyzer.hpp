@@ -0,0 +1,692 @@
+#ifndef CAST_ANALYZER_HPP
+#define CAST_ANALYZER_HPP
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <iomanip>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "BoundedQueue.hpp"
+#include "CastMatcher.hpp"
+#include "CodeLexer.hpp"
+#include "FileAnalysis.hpp"
+#include "ResultWriter.hpp"
+#include "ScanCache.hpp"
+#include "ScanIndex.hpp"
+#include "ScanStats.hpp"
+#include "SourceFile.hpp"
+#include "WorkStealingQueue.hpp"
+#include "split.hpp"
+
+namespace fs = std::filesystem;
+
+class CastAnalyzer
+{
+private:
+    ScanIndex index;
+    std::vector<std::string> filePaths;
+    // The keywords are fixed at compile time, and so is the cache signature
+    // derived from them.
+    static constexpr project2::string_view castTypeNames[] = {
+        "static_cast",
+        "dynamic_cast",
+        "const_cast",
+        "reinterpret_cast"};
+    static constexpr uint64_t castSignature = ScanCache::signature(castTypeNames);
+    std::vector<std::string> castTypes{std::begin(castTypeNames), std::end(castTypeNames)};
+    CastMatcher matcher{castTypes};
+    std::vector<size_t> typesByName = sortedByName(castTypes); // summary order
+    ScanCache cache{castSignature};
+    std::string cachePath;
+    ResultWriter *writer = nullptr;
+    mutable std::mutex writerMutex;
+    ScanStats stats;
+    size_t readers = 0; // reader threads; 0 scans without the pipeline
+    size_t queueDepth = 64;
+
+    // What one worker produced: the analyses that found casts, and a fresh
+    // cache record for every file it looked at.
+    struct WorkerOutput
+    {
+        std::vector<std::pair<uint32_t, FileAnalysis>> results;
+        std::vector<std::pair<uint32_t, ScanCache::Entry>> records;
+        size_t reused = 0;
+        std::string record; // formatting buffer for the result writer
+        CodeLexer lexer;    // holds the code image of the file being scanned
+        ScanStats stats;
+    };
+
+    // Progress messages must stay off stdout while results stream there.
+    std::ostream &status() const
+    {
+        return writer ? std::cerr : std::cout;
+    }
+
+    static std::vector<size_t> sortedByName(const std::vector<std::string> &types)
+    {
+        std::vector<size_t> order(types.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&types](size_t a, size_t b)
+                  { return types[a] < types[b]; });
+        return order;
+    }
+
+    bool isCppFile(const std::string &path) const
+    {
+        std::string ext = fs::path(path).extension().string();
+        return ext == ".cpp" || ext == ".h" || ext == ".hpp";
+    }
+
+    // Renders the cast line and up to contextSize lines on either side from
+    // text, the file's current contents.
+    static std::string renderContext(project2::string_view text, const CastOccurrence &occ, size_t contextSize = 2)
+    {
+        if (occ.offset >= text.size())
+        {
+            return "(source no longer available)\n";
+        }
+
+        size_t start = occ.offset;
+        size_t firstLine = occ.lineNumber;
+        for (size_t back = 0; start > 0; ++back)
+        {
+            size_t newline = text.rfind('\n', start - 1);
+            start = (newline == project2::string_view::npos) ? 0 : newline + 1;
+            if (back == contextSize || start == 0)
+            {
+                break;
+            }
+            --start;
+            --firstLine;
+        }
+
+        // A final newline ends the last line rather than starting an empty one.
+        project2::string_view rest = text.substr(start);
+        if (rest.ends_with("\n"))
+        {
+            rest.remove_suffix(1);
+        }
+
+        std::string context;
+        size_t line = firstLine;
+        size_t lastLine = occ.lineNumber + contextSize;
+        for (project2::string_view sourceLine : project2::split(rest, '\n'))
+        {
+            if (line > lastLine)
+            {
+                break;
+            }
+            context += std::to_string(line++);
+            context += ": ";
+            context.append(sourceLine.data(), sourceLine.size());
+            context += '\n';
+        }
+        return context;
+    }
+
+    // The matcher runs over the code image of the whole file, so casts in
+    // comments, literals and directives are skipped and a cast split across
+    // lines is still found. Every cast is reported, in source order, at the
+    // line of its keyword.
+    void scanSource(uint32_t fileId, project2::string_view code, FileAnalysis &analysis) const
+    {
+        const char *base = code.data();
+        const char *counted = base;
+        uint32_t lineNumber = 1;
+        matcher.scan(base, base + code.size(),
+                     [&](size_t type, size_t offset)
+                     {
+                         // Matches arrive in order, so each newline is counted once.
+                         lineNumber += static_cast<uint32_t>(std::count(counted, base + offset, '\n'));
+                         counted = base + offset;
+
+                         CastOccurrence occurrence;
+                         occurrence.offset = offset;
+                         occurrence.fileId = fileId;
+                         occurrence.lineNumber = lineNumber;
+                         occurrence.castType = static_cast<uint8_t>(type);
+                         analysis.occurrences.push_back(occurrence);
+                     });
+    }
+
+    // A file between the I/O half and the matching half of the scan. source
+    // stays null when the cached result is reused without opening the file.
+    struct LoadedFile
+    {
+        uint32_t fileId = 0;
+        const std::string *path = nullptr;
+        SourceFile *source = nullptr;
+        const ScanCache::Entry *cached = nullptr;
+        ScanCache::Entry record;
+        bool statted = false;
+        bool reuse = false;
+    };
+
+    // With the cache enabled, a file whose size and mtime match its cached
+    // entry is not opened at all, and one whose content hash still matches
+    // is not rescanned. source is the caller's reusable file buffer; with
+    // prefetch, its pages are faulted in before this returns. Returns false
+    // if the file could not be opened.
+    bool loadFile(LoadedFile &file, SourceFile &source, ScanStats &stats, bool prefetch = false) const
+    {
+        const std::string &filepath = *file.path;
+        ScanStats::Clock::time_point start = ScanStats::Clock::now();
+        ++stats.files;
+        const bool caching = !cachePath.empty();
+        file.cached = caching ? cache.find(filepath) : nullptr;
+        ScanCache::Entry &record = file.record;
+
+        file.statted = caching && ScanCache::stat(filepath, record.size, record.mtime);
+        if (file.statted && file.cached && file.cached->size == record.size && file.cached->mtime == record.mtime)
+        {
+            record.hash = file.cached->hash;
+            file.reuse = true;
+        }
+        else
+        {
+            if (!source.open(filepath))
+            {
+                std::cerr << "Failed to open file: " << filepath << std::endl;
+                stats.io += ScanStats::lap(start);
+                return false;
+            }
+            file.source = &source;
+            stats.bytes += source.contents().size();
+            if (prefetch)
+            {
+                source.prefetch();
+            }
+            if (caching)
+            {
+                record.hash = ScanCache::hash(source.contents());
+                file.reuse = file.cached && file.cached->size == source.contents().size() &&
+                             file.cached->hash == record.hash;
+            }
+        }
+
+        stats.io += ScanStats::lap(start);
+        return true;
+    }
+
+    void finishFile(LoadedFile &file, WorkerOutput &out) const
+    {
+        const uint32_t fileId = file.fileId;
+        const ScanCache::Entry *cached = file.cached;
+        ScanCache::Entry &record = file.record;
+        ScanStats::Clock::time_point start = ScanStats::Clock::now();
+
+        FileAnalysis analysis;
+        if (file.reuse)
+        {
+            for (const auto &entry : cached->occurrences)
+            {
+                analysis.occurrences.push_back({static_cast<size_t>(entry.offset), fileId, entry.lineNumber, entry.castType});
+            }
+            ++out.reused;
+        }
+        else
+        {
+            project2::string_view code = out.lexer.strip(file.source->contents());
+            out.stats.lex += ScanStats::lap(start);
+            scanSource(fileId, code, analysis);
+            out.stats.match += ScanStats::lap(start);
+            ++out.stats.scanned;
+        }
+
+        if (file.statted)
+        {
+            if (file.reuse)
+            {
+                record.occurrences = cached->occurrences;
+            }
+            else
+            {
+                for (const auto &occ : analysis.occurrences)
+                {
+                    record.occurrences.push_back({occ.offset, occ.lineNumber, occ.castType});
+                }
+            }
+            out.records.emplace_back(fileId, std::move(record));
+        }
+        if (analysis.occurrences.empty())
+        {
+            return;
+        }
+        if (writer)
+        {
+            out.record.clear();
+            writer->format(out.record, *file.path, analysis);
+            {
+                std::lock_guard<std::mutex> lock(writerMutex);
+                writer->write(out.record);
+            }
+            out.stats.output += ScanStats::lap(start);
+        }
+        else
+        {
+            out.results.emplace_back(fileId, std::move(analysis));
+        }
+    }
+
+    void analyzeFile(uint32_t fileId, SourceFile &source, WorkerOutput &out) const
+    {
+        LoadedFile file;
+        file.fileId = fileId;
+        file.path = &filePaths[fileId];
+        if (loadFile(file, source, out.stats))
+        {
+            finishFile(file, out);
+        }
+    }
+
+    // Calls onFile(path) for every C++ source below path, in directory order.
+    template <typename OnFile>
+    void walkFiles(const std::string &path, OnFile &&onFile) const
+    {
+        try
+        {
+            for (const auto &entry : fs::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file() && isCppFile(entry.path().string()))
+                {
+                    onFile(entry.path().string());
+                }
+            }
+        }
+        catch (const fs::filesystem_error &e)
+        {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+        }
+    }
+
+    std::vector<std::string> collectFiles(const std::string &path) const
+    {
+        std::vector<std::string> files;
+        walkFiles(path, [&files](std::string file)
+                  { files.push_back(std::move(file)); });
+        return files;
+    }
+
+    // Each worker keeps what it produced in its own WorkerOutput; the outputs
+    // are merged after the workers have joined, so the scan itself needs no
+    // shared lock on the results.
+    void analyzeParallel(std::vector<WorkerOutput> &outputs) const
+    {
+        const size_t jobs = outputs.size();
+        const size_t count = filePaths.size();
+        WorkStealingQueue queue(jobs);
+        // Hand out contiguous runs so files from the same directory tend to
+        // stay on the same worker; stealing evens out the load afterwards.
+        for (size_t i = 0; i < count; ++i)
+        {
+            queue.push(i * jobs / count, i);
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(jobs);
+        for (size_t w = 0; w < jobs; ++w)
+        {
+            workers.emplace_back([this, &queue, &outputs, w]
+                                 {
+                SourceFile source;
+                size_t index;
+                while (queue.pop(w, index))
+                {
+                    analyzeFile(static_cast<uint32_t>(index), source, outputs[w]);
+                } });
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Walker, readers and matchers run at the same time, connected by
+    // bounded queues. The walker hands out paths as it finds them; readers
+    // stat, open and prefetch files, up to queueDepth ahead of the matchers,
+    // so I/O latency overlaps with matching. SourceFile buffers circulate
+    // through an idle pool sized so that no stage can starve another.
+    void analyzePipelined(const std::string &path, std::vector<WorkerOutput> &outputs)
+    {
+        std::deque<std::string> walked; // stable addresses while it grows
+        BoundedQueue<LoadedFile> found(queueDepth);
+        BoundedQueue<LoadedFile> loaded(queueDepth);
+        std::vector<std::unique_ptr<SourceFile>> sources(queueDepth + readers + outputs.size());
+        BoundedQueue<SourceFile *> idle(sources.size());
+        for (auto &source : sources)
+        {
+            source = std::make_unique<SourceFile>();
+            idle.push(source.get());
+        }
+
+        std::thread walker([this, &path, &walked, &found]
+                           {
+            // Time blocked on a full queue is back-pressure, not walking.
+            ScanStats::Clock::time_point start = ScanStats::Clock::now();
+            walkFiles(path, [this, &walked, &found, &start](std::string file)
+                      {
+                stats.walk += ScanStats::lap(start);
+                walked.push_back(std::move(file));
+                LoadedFile item;
+                item.fileId = static_cast<uint32_t>(walked.size() - 1);
+                item.path = &walked.back();
+                found.push(std::move(item));
+                start = ScanStats::Clock::now(); });
+            stats.walk += ScanStats::lap(start);
+            found.close(); });
+
+        std::vector<ScanStats> readerStats(readers);
+        std::vector<std::thread> readerThreads;
+        readerThreads.reserve(readers);
+        for (size_t r = 0; r < readers; ++r)
+        {
+            readerThreads.emplace_back([this, &found, &loaded, &idle, &readerStats, r]
+                                       {
+                LoadedFile item;
+                while (found.pop(item))
+                {
+                    SourceFile *source = nullptr;
+                    idle.pop(source);
+                    if (!loadFile(item, *source, readerStats[r], true))
+                    {
+                        idle.push(source);
+                        continue;
+                    }
+                    if (!item.source)
+                    {
+                        idle.push(source);
+                    }
+                    loaded.push(std::move(item));
+                } });
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(outputs.size());
+        for (size_t w = 0; w < outputs.size(); ++w)
+        {
+            workers.emplace_back([this, &loaded, &idle, &outputs, w]
+                                 {
+                LoadedFile item;
+                while (loaded.pop(item))
+                {
+                    finishFile(item, outputs[w]);
+                    if (item.source)
+                    {
+                        item.source->close();
+                        idle.push(item.source);
+                    }
+                } });
+        }
+
+        walker.join();
+        for (auto &reader : readerThreads)
+        {
+            reader.join();
+        }
+        loaded.close();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        filePaths.assign(std::make_move_iterator(walked.begin()), std::make_move_iterator(walked.end()));
+        for (const auto &readerStat : readerStats)
+        {
+            stats.add(readerStat);
+        }
+    }
+
+    void mergeOutputs(std::vector<WorkerOutput> &outputs)
+    {
+        ScanStats::Clock::time_point start = ScanStats::Clock::now();
+        // The cache is rewritten to hold exactly the files of this scan.
+        size_t reused = 0;
+        if (!cachePath.empty())
+        {
+            cache.clear();
+        }
+        std::vector<std::pair<uint32_t, FileAnalysis>> results;
+        for (auto &out : outputs)
+        {
+            std::move(out.results.begin(), out.results.end(), std::back_inserter(results));
+            for (auto &[id, record] : out.records)
+            {
+                cache.store(filePaths[id], std::move(record));
+            }
+            reused += out.reused;
+            stats.add(out.stats);
+        }
+        index.build(filePaths, std::move(results), castTypes.size());
+
+        if (!cachePath.empty())
+        {
+            status() << "Reused cached results for " << reused << " of " << cache.size() << " files\n";
+            if (!cache.save(cachePath))
+            {
+                std::cerr << "Failed to write cache: " << cachePath << std::endl;
+            }
+        }
+        stats.index += ScanStats::lap(start);
+    }
+
+public:
+    const std::vector<std::string> &getCastTypes() const
+    {
+        return castTypes;
+    }
+
+    // Keeps scan results in path between runs; see ScanCache.
+    void setCachePath(const std::string &path)
+    {
+        cachePath = path;
+    }
+
+    // While a writer is set, each file's results are streamed to it as soon
+    // as the file is done instead of being kept for the interactive menu.
+    void setResultWriter(ResultWriter *resultWriter)
+    {
+        writer = resultWriter;
+    }
+
+    // With readerThreads > 0, scans run as a walker -> readers -> matchers
+    // pipeline (see analyzePipelined) with queues of depth files between
+    // the stages. Worth it where opening and reading a file has high latency,
+    // as on network filesystems.
+    void setPipeline(size_t readerThreads, size_t depth)
+    {
+        readers = readerThreads;
+        queueDepth = std::max<size_t>(1, depth);
+    }
+
+    // Counters and timings of the last analyzePath.
+    const ScanStats &getStats() const
+    {
+        return stats;
+    }
+
+    // Scans path, replacing the results of any previous scan.
+    void analyzePath(const std::string &path, size_t jobs = 1)
+    {
+        ScanStats::Clock::time_point begin = ScanStats::Clock::now();
+        ScanStats::Clock::time_point start = begin;
+        stats = ScanStats();
+        if (!cachePath.empty())
+        {
+            cache.load(cachePath);
+        }
+        stats.io += ScanStats::lap(start);
+
+        if (readers > 0)
+        {
+            std::vector<WorkerOutput> outputs(std::max<size_t>(1, jobs));
+            stats.workers = outputs.size();
+            stats.readers = readers;
+            analyzePipelined(path, outputs);
+            mergeOutputs(outputs);
+            stats.elapsed = ScanStats::lap(begin);
+            return;
+        }
+
+        filePaths = collectFiles(path);
+        stats.walk += ScanStats::lap(start);
+        jobs = std::max<size_t>(1, std::min(jobs, filePaths.size()));
+        stats.workers = jobs;
+
+        std::vector<WorkerOutput> outputs(jobs);
+        if (jobs == 1)
+        {
+            SourceFile source;
+            for (uint32_t id = 0; id < filePaths.size(); ++id)
+            {
+                analyzeFile(id, source, outputs[0]);
+            }
+        }
+        else
+        {
+            analyzeParallel(outputs);
+        }
+        mergeOutputs(outputs);
+        stats.elapsed = ScanStats::lap(begin);
+    }
+
+    void displayMenu()
+    {
+        while (true)
+        {
+            std::cout << "\n=== Cast Analyzer Menu ===\n";
+            std::cout << "1. Show summary of all files\n";
+            std::cout << "2. Show detailed analysis for a specific file\n";
+            std::cout << "3. Search by cast type\n";
+            std::cout << "4. Exit\n";
+            std::cout << "Enter your choice (1-4): ";
+
+            int choice;
+            std::cin >> choice;
+            std::cin.ignore();
+
+            switch (choice)
+            {
+            case 1:
+                showSummary();
+                break;
+            case 2:
+                showFileDetails();
+                break;
+            case 3:
+                searchByCastType();
+                break;
+            case 4:
+                return;
+            default:
+                std::cout << "Invalid choice. Please try again.\n";
+            }
+        }
+    }
+
+private:
+    void showSummary()
+    {
+        std::cout << "\n=== Summary of Cast Usage ===\n";
+        for (size_t file = 0; file < index.fileCount(); ++file)
+        {
+            std::cout << "\nFile: " << filePaths[index.fileId(file)] << "\n";
+            std::cout << "Total casts found: " << index.end(file) - index.begin(file) << "\n";
+
+            for (size_t type : typesByName)
+            {
+                if (uint32_t count = index.count(file, type))
+                {
+                    std::cout << "  " << castTypes[type] << ": " << count << "\n";
+                }
+            }
+        }
+    }
+
+    void showFileDetails()
+    {
+        std::cout << "\nAvailable files:\n";
+        for (size_t file = 0; file < index.fileCount(); ++file)
+        {
+            std::cout << file + 1 << ". " << filePaths[index.fileId(file)] << "\n";
+        }
+
+        std::cout << "Enter file number: ";
+        int fileChoice;
+        std::cin >> fileChoice;
+        std::cin.ignore();
+
+        if (fileChoice < 1 || static_cast<size_t>(fileChoice) > index.fileCount())
+        {
+            std::cout << "Invalid file number.\n";
+            return;
+        }
+
+        const size_t file = static_cast<size_t>(fileChoice - 1);
+        const std::string &path = filePaths[index.fileId(file)];
+        SourceFile source;
+        source.open(path);
+
+        std::cout << "\nDetailed analysis for: " << path << "\n";
+        for (size_t i = index.begin(file); i < index.end(file); ++i)
+        {
+            CastOccurrence occ = index.occurrence(i);
+            std::cout << "\n=== " << castTypes[occ.castType] << " at line " << occ.lineNumber << " ===\n";
+            std::cout << "Context:\n"
+                      << renderContext(source.contents(), occ) << "\n";
+        }
+    }
+
+    void searchByCastType()
+    {
+        std::cout << "\nAvailable cast types:\n";
+        for (size_t i = 0; i < castTypes.size(); ++i)
+        {
+            std::cout << i + 1 << ". " << castTypes[i] << "\n";
+        }
+
+        std::cout << "Enter cast type number: ";
+        int typeChoice;
+        std::cin >> typeChoice;
+        std::cin.ignore();
+
+        if (typeChoice < 1 || static_cast<size_t>(typeChoice) > castTypes.size())
+        {
+            std::cout << "Invalid cast type.\n";
+            return;
+        }
+
+        const size_t selectedType = static_cast<size_t>(typeChoice - 1);
+        std::cout << "\nOccurrences of " << castTypes[selectedType] << ":\n";
+
+        // Postings are grouped by file, so each file is opened once.
+        SourceFile source;
+        size_t openFile = index.fileCount();
+        for (uint32_t i : index.postings(selectedType))
+        {
+            CastOccurrence occ = index.occurrence(i);
+            const std::string &path = filePaths[occ.fileId];
+            if (index.owner(i) != openFile)
+            {
+                openFile = index.owner(i);
+                source.open(path);
+            }
+            std::cout << "\nFile: " << path << "\n";
+            std::cout << "Line " << occ.lineNumber << ":\n";
+            std::cout << renderContext(source.contents(), occ) << "\n";
+        }
+    }
+};
+
+#endif // CAST_ANALYZER_HPP
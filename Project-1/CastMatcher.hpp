@@ -0,0 +1,124 @@
+#ifndef CAST_MATCHER_HPP
+#define CAST_MATCHER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "searcher.hpp"
+
+// Finds `keyword <...> (` cast expressions for a fixed set of keywords in a
+// single forward pass. Keyword candidates come from a project2::multi_searcher,
+// which filters whole blocks of input with SIMD compares on two rare bytes of
+// each keyword; every hit is then confirmed by a small recognizer for the
+// template argument list and the opening parenthesis.
+class CastMatcher
+{
+private:
+    project2::multi_searcher keywords;
+    std::vector<size_t> keywordLength;
+
+    static bool isIdentifier(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    static const char *skipSpace(const char *p, const char *end)
+    {
+        while (p != end && isSpace(*p))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    // Accepts `\s*<...>\s*(` starting at p. Angle brackets nest; brackets
+    // inside parentheses or square brackets, and the `>` of `->`, do not
+    // count towards the nesting depth.
+    static bool matchTemplateCall(const char *p, const char *end)
+    {
+        p = skipSpace(p, end);
+        if (p == end || *p != '<')
+        {
+            return false;
+        }
+
+        int angles = 0;
+        int parens = 0;
+        for (; p != end; ++p)
+        {
+            switch (*p)
+            {
+            case '(':
+            case '[':
+                ++parens;
+                break;
+            case ')':
+            case ']':
+                if (--parens < 0)
+                {
+                    return false;
+                }
+                break;
+            case '<':
+                if (parens == 0)
+                {
+                    ++angles;
+                }
+                break;
+            case '>':
+                if (parens == 0 && p[-1] != '-' && --angles == 0)
+                {
+                    p = skipSpace(p + 1, end);
+                    return p != end && *p == '(';
+                }
+                break;
+            case ';':
+            case '{':
+            case '}':
+                return false;
+            }
+        }
+        return false;
+    }
+
+public:
+    explicit CastMatcher(const std::vector<std::string> &keywords) : keywords(keywords.begin(), keywords.end())
+    {
+        for (const auto &keyword : keywords)
+        {
+            keywordLength.push_back(keyword.size());
+        }
+    }
+
+    // Calls onMatch(keywordIndex, offset) for every cast expression in
+    // [begin, end), in order of position; offset is the index of the first
+    // character of the keyword. A keyword that is the tail of a longer
+    // identifier (my_static_cast) does not count.
+    template <typename OnMatch>
+    void scan(const char *begin, const char *end, OnMatch &&onMatch) const
+    {
+        const project2::string_view text(begin, static_cast<size_t>(end - begin));
+        for (size_t pos = 0;;)
+        {
+            const project2::multi_searcher::match hit = keywords.find_in(text, pos);
+            if (hit.position == project2::string_view::npos)
+            {
+                return;
+            }
+            const size_t offset = hit.position;
+            if ((offset == 0 || !isIdentifier(begin[offset - 1])) &&
+                matchTemplateCall(begin + offset + keywordLength[hit.needle], end))
+            {
+                onMatch(hit.needle, offset);
+            }
+            pos = offset + 1;
+        }
+    }
+};
+
+#endif // CAST_MATCHER_HPP
@@ -0,0 +1,302 @@
+#ifndef CODE_LEXER_HPP
+#define CODE_LEXER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include "string_view.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CODE_LEXER_HAS_SSE2 1
+#endif
+
+// Single-pass C++ lexer stage that produces the "code image" of a buffer: a
+// copy in which comments, string and character literals (raw strings
+// included) and the text of preprocessor directives other than #define are
+// replaced by spaces. Newlines are kept, so offsets and line numbers in the
+// image are those of the source, and a matcher run over it only sees code,
+// with casts split across lines intact. Macro bodies count as code.
+//
+// Plain code is copied in 16-byte blocks until the next byte that can start a
+// comment, literal or directive, so the common case runs near memcpy speed.
+class CodeLexer
+{
+private:
+    std::string image_;
+
+    static bool isIdentifier(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    static bool isSpecial(char c)
+    {
+        return c == '/' || c == '"' || c == '\'' || c == '#';
+    }
+
+    // Index of the next byte at or after i that isSpecial, or size.
+    static size_t nextSpecial(const char *src, size_t i, size_t size)
+    {
+#ifdef CODE_LEXER_HAS_SSE2
+        const __m128i slash = _mm_set1_epi8('/');
+        const __m128i dquote = _mm_set1_epi8('"');
+        const __m128i squote = _mm_set1_epi8('\'');
+        const __m128i hash = _mm_set1_epi8('#');
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, slash), _mm_cmpeq_epi8(block, dquote)),
+                                       _mm_or_si128(_mm_cmpeq_epi8(block, squote), _mm_cmpeq_epi8(block, hash)));
+            if (int mask = _mm_movemask_epi8(hit))
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+#else
+                size_t first = 0;
+                while (!(mask & (1 << first)))
+                {
+                    ++first;
+                }
+                return i + first;
+#endif
+            }
+        }
+#endif
+        while (i < size && !isSpecial(src[i]))
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    // Blanks [from, to) in the image, keeping newlines.
+    void blank(size_t from, size_t to)
+    {
+        for (size_t i = from; i < to; ++i)
+        {
+            if (image_[i] != '\n')
+            {
+                image_[i] = ' ';
+            }
+        }
+    }
+
+    // End of the line starting at or after i, treating backslash-newline as
+    // a continuation.
+    static size_t logicalLineEnd(const char *src, size_t i, size_t size)
+    {
+        for (;; ++i)
+        {
+            const void *newline = std::memchr(src + i, '\n', size - i);
+            if (!newline)
+            {
+                return size;
+            }
+            i = static_cast<size_t>(static_cast<const char *>(newline) - src);
+            size_t before = i;
+            if (before > 0 && src[before - 1] == '\r')
+            {
+                --before;
+            }
+            if (before == 0 || src[before - 1] != '\\')
+            {
+                return i;
+            }
+        }
+    }
+
+    // End (one past the closing quote) of a quoted literal opening at i, with
+    // backslash escapes. An unterminated literal stops at the end of line.
+    static size_t quotedEnd(const char *src, size_t i, size_t size)
+    {
+        const char quote = src[i];
+        for (++i; i < size; ++i)
+        {
+            if (src[i] == '\\')
+            {
+                ++i;
+            }
+            else if (src[i] == quote)
+            {
+                return i + 1;
+            }
+            else if (src[i] == '\n')
+            {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    // If the '"' at i closes the prefix of a raw string literal (R, u8R, uR,
+    // UR or LR, not part of a longer identifier), returns the index where the
+    // prefix starts; otherwise npos.
+    static size_t rawStringStart(const char *src, size_t i)
+    {
+        if (i == 0 || src[i - 1] != 'R')
+        {
+            return std::string::npos;
+        }
+        size_t start = i - 1;
+        if (start >= 2 && src[start - 2] == 'u' && src[start - 1] == '8')
+        {
+            start -= 2;
+        }
+        else if (start >= 1 && (src[start - 1] == 'u' || src[start - 1] == 'U' || src[start - 1] == 'L'))
+        {
+            start -= 1;
+        }
+        if (start > 0 && isIdentifier(src[start - 1]))
+        {
+            return std::string::npos;
+        }
+        return start;
+    }
+
+    // End of the raw string whose opening quote is at i.
+    static size_t rawStringEnd(const char *src, size_t i, size_t size)
+    {
+        size_t open = i + 1;
+        while (open < size && open - i <= 17 && src[open] != '(' && src[open] != '\n')
+        {
+            ++open;
+        }
+        if (open >= size || src[open] != '(')
+        {
+            return quotedEnd(src, i, size);
+        }
+
+        std::string terminator = ")";
+        terminator.append(src + i + 1, open - i - 1);
+        terminator += '"';
+        project2::string_view rest(src + open, size - open);
+        size_t close = rest.find(project2::string_view(terminator));
+        return close == project2::string_view::npos ? size : open + close + terminator.size();
+    }
+
+    // True if the "'" at i is a digit separator (as in 1'000) rather than
+    // the start of a character literal.
+    static bool isDigitSeparator(const char *src, size_t i)
+    {
+        size_t start = i;
+        while (start > 0 && (isIdentifier(src[start - 1]) || src[start - 1] == '\'' || src[start - 1] == '.'))
+        {
+            --start;
+        }
+        return start < i && src[start] >= '0' && src[start] <= '9';
+    }
+
+    // True if only blanks precede position i on its line of the image.
+    bool atLineStart(size_t i) const
+    {
+        while (i > 0 && (image_[i - 1] == ' ' || image_[i - 1] == '\t'))
+        {
+            --i;
+        }
+        return i == 0 || image_[i - 1] == '\n';
+    }
+
+public:
+    // Returns the code image of source. The view refers to storage inside
+    // the lexer and stays valid until the next call; the storage is reused,
+    // so steady-state calls do not allocate.
+    project2::string_view strip(project2::string_view source)
+    {
+        const char *src = source.data();
+        const size_t size = source.size();
+        image_.assign(src, size);
+
+        size_t i = 0;
+        while ((i = nextSpecial(src, i, size)) < size)
+        {
+            size_t end = i + 1;
+            switch (src[i])
+            {
+            case '/':
+                if (i + 1 < size && src[i + 1] == '/')
+                {
+                    end = logicalLineEnd(src, i, size);
+                }
+                else if (i + 1 < size && src[i + 1] == '*')
+                {
+                    const char *close = nullptr;
+                    if (i + 2 < size)
+                    {
+                        project2::string_view rest(src + i + 2, size - i - 2);
+                        size_t found = rest.find("*/");
+                        close = found == project2::string_view::npos ? nullptr : src + i + 2 + found;
+                    }
+                    end = close ? static_cast<size_t>(close - src) + 2 : size;
+                }
+                else
+                {
+                    i = end;
+                    continue;
+                }
+                break;
+            case '"':
+            {
+                size_t prefix = rawStringStart(src, i);
+                if (prefix != std::string::npos)
+                {
+                    end = rawStringEnd(src, i, size);
+                    i = prefix;
+                }
+                else
+                {
+                    end = quotedEnd(src, i, size);
+                }
+                break;
+            }
+            case '\'':
+                if (isDigitSeparator(src, i))
+                {
+                    i = end;
+                    continue;
+                }
+                end = quotedEnd(src, i, size);
+                break;
+            case '#':
+            {
+                if (!atLineStart(i))
+                {
+                    i = end;
+                    continue;
+                }
+                size_t name = i + 1;
+                while (name < size && (src[name] == ' ' || src[name] == '\t'))
+                {
+                    ++name;
+                }
+                if (size - name >= 6 && std::memcmp(src + name, "define", 6) == 0)
+                {
+                    i = name + 6;
+                    continue;
+                }
+                // Stop at a comment so that a block comment opened on the
+                // directive line is lexed as one.
+                end = logicalLineEnd(src, i, size);
+                project2::string_view directive(src + i, end - i);
+                size_t comment = directive.find('/');
+                while (comment != project2::string_view::npos && comment + 1 < directive.size() &&
+                       directive[comment + 1] != '/' && directive[comment + 1] != '*')
+                {
+                    comment = directive.find('/', comment + 1);
+                }
+                if (comment != project2::string_view::npos && comment + 1 < directive.size())
+                {
+                    end = i + comment;
+                }
+                break;
+            }
+            }
+            blank(i, end);
+            i = end;
+        }
+
+        return project2::string_view(image_.data(), image_.size());
+    }
+};
+
+#endif // CODE_LEXER_HPP
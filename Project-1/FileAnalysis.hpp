@@ -0,0 +1,23 @@
+#ifndef FILE_ANALYSIS_HPP
+#define FILE_ANALYSIS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Only the position of a cast is kept; the surrounding source is rendered
+// from the file on demand (see renderContext).
+struct CastOccurrence
+{
+    size_t offset;       // byte offset of the cast keyword in the file
+    uint32_t fileId;     // index into CastAnalyzer::filePaths
+    uint32_t lineNumber; // 1-based
+    uint8_t castType;    // index into CastAnalyzer::castTypes
+};
+
+struct FileAnalysis
+{
+    std::vector<CastOccurrence> occurrences;
+};
+
+#endif // FILE_ANALYSIS_HPP
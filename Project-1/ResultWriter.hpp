@@ -0,0 +1,258 @@
+#ifndef RESULT_WRITER_HPP
+#define RESULT_WRITER_HPP
+
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "FileAnalysis.hpp"
+
+// Streams scan results in a machine-readable format, one file at a time.
+// format() only builds text and is called concurrently by the scan workers;
+// write() appends a finished record to the stream and is called by one
+// thread at a time. Every record is flushed as soon as it is written, so a
+// consumer sees each file as soon as its scan finishes.
+class ResultWriter
+{
+protected:
+    std::ostream &os;
+    const std::vector<std::string> &castTypes;
+    bool first = true;
+
+    static void appendJsonString(std::string &out, const std::string &text)
+    {
+        out += '"';
+        for (unsigned char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+                else
+                {
+                    out += static_cast<char>(c);
+                }
+            }
+        }
+        out += '"';
+    }
+
+    // Written between two records.
+    virtual const char *separator() const
+    {
+        return "";
+    }
+
+public:
+    ResultWriter(std::ostream &os, const std::vector<std::string> &castTypes) : os(os), castTypes(castTypes) {}
+    virtual ~ResultWriter() = default;
+
+    virtual void begin() {}
+    virtual void end() {}
+
+    // Appends the record for one file to out.
+    virtual void format(std::string &out, const std::string &path, const FileAnalysis &analysis) const = 0;
+
+    void write(const std::string &record)
+    {
+        if (record.empty())
+        {
+            return;
+        }
+        if (!first)
+        {
+            os << separator();
+        }
+        first = false;
+        os << record;
+        os.flush();
+    }
+
+    // Returns nullptr for an unknown format name.
+    static std::unique_ptr<ResultWriter> create(const std::string &format, std::ostream &os,
+                                                const std::vector<std::string> &castTypes);
+};
+
+// A JSON array with one object per file, each on its own line.
+class JsonResultWriter : public ResultWriter
+{
+protected:
+    const char *separator() const override
+    {
+        return ",\n";
+    }
+
+public:
+    using ResultWriter::ResultWriter;
+
+    void begin() override
+    {
+        os << "[\n";
+        os.flush();
+    }
+
+    void end() override
+    {
+        os << (first ? "]\n" : "\n]\n");
+        os.flush();
+    }
+
+    void format(std::string &out, const std::string &path, const FileAnalysis &analysis) const override
+    {
+        out += "{\"file\":";
+        appendJsonString(out, path);
+        out += ",\"casts\":[";
+        for (size_t i = 0; i < analysis.occurrences.size(); ++i)
+        {
+            const CastOccurrence &occ = analysis.occurrences[i];
+            out += i ? ",{\"type\":\"" : "{\"type\":\"";
+            out += castTypes[occ.castType];
+            out += "\",\"line\":";
+            out += std::to_string(occ.lineNumber);
+            out += ",\"offset\":";
+            out += std::to_string(occ.offset);
+            out += '}';
+        }
+        out += "]}";
+    }
+};
+
+// One row per occurrence, RFC 4180 quoting.
+class CsvResultWriter : public ResultWriter
+{
+private:
+    static void appendField(std::string &out, const std::string &field)
+    {
+        if (field.find_first_of(",\"\r\n") == std::string::npos)
+        {
+            out += field;
+            return;
+        }
+        out += '"';
+        for (char c : field)
+        {
+            if (c == '"')
+            {
+                out += '"';
+            }
+            out += c;
+        }
+        out += '"';
+    }
+
+public:
+    using ResultWriter::ResultWriter;
+
+    void begin() override
+    {
+        os << "file,line,cast_type,offset\n";
+        os.flush();
+    }
+
+    void format(std::string &out, const std::string &path, const FileAnalysis &analysis) const override
+    {
+        for (const auto &occ : analysis.occurrences)
+        {
+            appendField(out, path);
+            out += ',';
+            out += std::to_string(occ.lineNumber);
+            out += ',';
+            out += castTypes[occ.castType];
+            out += ',';
+            out += std::to_string(occ.offset);
+            out += '\n';
+        }
+    }
+};
+
+// A SARIF 2.1.0 log with a single run; every cast is a result whose rule is
+// the cast type.
+class SarifResultWriter : public ResultWriter
+{
+protected:
+    const char *separator() const override
+    {
+        return ",\n";
+    }
+
+public:
+    using ResultWriter::ResultWriter;
+
+    void begin() override
+    {
+        os << "{\"version\":\"2.1.0\","
+              "\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+              "\"runs\":[{\"tool\":{\"driver\":{\"name\":\"cast_analyzer\",\"rules\":[";
+        for (size_t i = 0; i < castTypes.size(); ++i)
+        {
+            os << (i ? "," : "") << "{\"id\":\"" << castTypes[i] << "\"}";
+        }
+        os << "]}},\"results\":[\n";
+        os.flush();
+    }
+
+    void end() override
+    {
+        os << (first ? "]}]}\n" : "\n]}]}\n");
+        os.flush();
+    }
+
+    void format(std::string &out, const std::string &path, const FileAnalysis &analysis) const override
+    {
+        for (size_t i = 0; i < analysis.occurrences.size(); ++i)
+        {
+            const CastOccurrence &occ = analysis.occurrences[i];
+            const std::string &type = castTypes[occ.castType];
+            if (i)
+            {
+                out += ",\n";
+            }
+            out += "{\"ruleId\":\"" + type + "\",\"ruleIndex\":" + std::to_string(occ.castType) +
+                   ",\"level\":\"note\",\"message\":{\"text\":\"" + type + " expression\"},"
+                   "\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":";
+            appendJsonString(out, path);
+            out += "},\"region\":{\"startLine\":" + std::to_string(occ.lineNumber) + "}}}]}";
+        }
+    }
+};
+
+inline std::unique_ptr<ResultWriter> ResultWriter::create(const std::string &format, std::ostream &os,
+                                                          const std::vector<std::string> &castTypes)
+{
+    if (format == "json")
+    {
+        return std::make_unique<JsonResultWriter>(os, castTypes);
+    }
+    if (format == "csv")
+    {
+        return std::make_unique<CsvResultWriter>(os, castTypes);
+    }
+    if (format == "sarif")
+    {
+        return std::make_unique<SarifResultWriter>(os, castTypes);
+    }
+    return nullptr;
+}
+
+#endif // RESULT_WRITER_HPP
@@ -0,0 +1,247 @@
+#ifndef SCAN_CACHE_HPP
+#define SCAN_CACHE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "string_view.hpp"
+
+// On-disk index of previous scan results, keyed by file path. An entry is
+// reused without opening the file when size and mtime are unchanged, and
+// without rescanning it when only the mtime moved but the content hash still
+// matches.
+//
+// File layout (native byte order; the cache is local to one machine):
+//   header:     magic "CAIX", u32 format version, u64 matcher signature,
+//               u64 entry count
+//   entry:      u32 path length, path bytes, u64 size, i64 mtime,
+//               u64 content hash, u32 occurrence count
+//   occurrence: u64 byte offset, u32 line number, u8 cast type
+class ScanCache
+{
+public:
+    struct Occurrence
+    {
+        uint64_t offset;
+        uint32_t lineNumber;
+        uint8_t castType;
+    };
+
+    struct Entry
+    {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t hash = 0;
+        std::vector<Occurrence> occurrences;
+    };
+
+    // Bump whenever the matching rules change, so stale results are dropped.
+    static constexpr uint32_t formatVersion = 2;
+
+    // FNV-1a, used for content hashes and the matcher signature.
+    static constexpr uint64_t hash(project2::string_view bytes, uint64_t seed = 14695981039346656037ull)
+    {
+        uint64_t h = seed;
+        for (char c : bytes)
+        {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Cached results are only valid for the keyword list they were made with.
+    // Each keyword is hashed with its terminating NUL, so the keywords must
+    // be views of string literals or other NUL-terminated strings.
+    template <size_t N>
+    static constexpr uint64_t signature(const project2::string_view (&keywords)[N])
+    {
+        uint64_t h = hash("");
+        for (const project2::string_view &keyword : keywords)
+        {
+            h = hash(project2::string_view(keyword.data(), keyword.size() + 1), h);
+        }
+        return h;
+    }
+
+    static bool stat(const std::string &path, uint64_t &size, int64_t &mtime)
+    {
+        std::error_code ec;
+        size = std::filesystem::file_size(path, ec);
+        if (ec)
+        {
+            return false;
+        }
+        auto time = std::filesystem::last_write_time(path, ec);
+        if (ec)
+        {
+            return false;
+        }
+        mtime = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    explicit ScanCache(uint64_t signature = 0) : signature_(signature) {}
+
+    // A missing, truncated or incompatible cache file loads as empty.
+    bool load(const std::string &path)
+    {
+        entries_.clear();
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Reader in{buffer.data(), buffer.data() + buffer.size()};
+        char magic[4];
+        uint32_t version = 0;
+        uint64_t signature = 0;
+        uint64_t count = 0;
+        if (!in.bytes(magic, sizeof(magic)) || std::memcmp(magic, "CAIX", 4) != 0 ||
+            !in.value(version) || version != formatVersion ||
+            !in.value(signature) || signature != signature_ || !in.value(count) ||
+            in.remaining() / 32 < count) // an entry takes at least 32 bytes
+        {
+            return false;
+        }
+
+        std::unordered_map<std::string, Entry> entries;
+        entries.reserve(static_cast<size_t>(count));
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint32_t pathLength = 0;
+            uint32_t occurrenceCount = 0;
+            Entry entry;
+            if (!in.value(pathLength) || in.remaining() < pathLength)
+            {
+                return false;
+            }
+            std::string filePath(in.pos, pathLength);
+            in.pos += pathLength;
+            if (!in.value(entry.size) || !in.value(entry.mtime) || !in.value(entry.hash) ||
+                !in.value(occurrenceCount) || in.remaining() / 13 < occurrenceCount)
+            {
+                return false;
+            }
+            entry.occurrences.resize(occurrenceCount);
+            for (auto &occ : entry.occurrences)
+            {
+                in.value(occ.offset);
+                in.value(occ.lineNumber);
+                in.value(occ.castType);
+            }
+            entries.emplace(std::move(filePath), std::move(entry));
+        }
+
+        entries_ = std::move(entries);
+        return true;
+    }
+
+    bool save(const std::string &path) const
+    {
+        std::string out;
+        out.append("CAIX", 4);
+        put(out, formatVersion);
+        put(out, signature_);
+        put(out, static_cast<uint64_t>(entries_.size()));
+        for (const auto &[filePath, entry] : entries_)
+        {
+            put(out, static_cast<uint32_t>(filePath.size()));
+            out += filePath;
+            put(out, entry.size);
+            put(out, entry.mtime);
+            put(out, entry.hash);
+            put(out, static_cast<uint32_t>(entry.occurrences.size()));
+            for (const auto &occ : entry.occurrences)
+            {
+                put(out, occ.offset);
+                put(out, occ.lineNumber);
+                put(out, occ.castType);
+            }
+        }
+
+        // Write to a temporary file and rename it over the old cache, so an
+        // interrupted save never leaves a half-written index behind.
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(out.data(), static_cast<std::streamsize>(out.size())))
+            {
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temporary, path, ec);
+        return !ec;
+    }
+
+    const Entry *find(const std::string &path) const
+    {
+        auto it = entries_.find(path);
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    void store(const std::string &path, Entry entry)
+    {
+        entries_[path] = std::move(entry);
+    }
+
+    void clear()
+    {
+        entries_.clear();
+    }
+
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+private:
+    struct Reader
+    {
+        const char *pos;
+        const char *end;
+
+        size_t remaining() const
+        {
+            return static_cast<size_t>(end - pos);
+        }
+
+        bool bytes(void *dst, size_t n)
+        {
+            if (remaining() < n)
+            {
+                return false;
+            }
+            std::memcpy(dst, pos, n);
+            pos += n;
+            return true;
+        }
+
+        template <typename T>
+        bool value(T &dst)
+        {
+            return bytes(&dst, sizeof(T));
+        }
+    };
+
+    template <typename T>
+    static void put(std::string &out, T value)
+    {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    uint64_t signature_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+#endif // SCAN_CACHE_HPP
@@ -0,0 +1,122 @@
+#ifndef SCAN_INDEX_HPP
+#define SCAN_INDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "FileAnalysis.hpp"
+
+// Read-only index over a finished scan, built once so the menu queries run in
+// time proportional to what they print. Files that contain casts are ranked
+// by path; their occurrences are stored column-wise, grouped by file rank, so
+// the occurrences of one file are the contiguous range
+// [begin(file), end(file)). Per-file counters and one posting list per cast
+// type are precomputed.
+class ScanIndex
+{
+private:
+    size_t typeCount = 0;
+
+    // per file rank
+    std::vector<uint32_t> fileIds;
+    std::vector<uint32_t> fileBegin; // fileCount() + 1 entries
+    std::vector<uint32_t> counts;    // rank * typeCount + type
+
+    // per occurrence
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> lineNumbers;
+    std::vector<uint8_t> castTypes;
+    std::vector<uint32_t> owners; // file rank
+
+    std::vector<std::vector<uint32_t>> postingLists; // per type, in rank order
+
+public:
+    // results holds (file id, analysis) pairs in any order; paths maps file
+    // ids to paths and decides the rank order.
+    void build(const std::vector<std::string> &paths, std::vector<std::pair<uint32_t, FileAnalysis>> results,
+               size_t types)
+    {
+        *this = ScanIndex();
+        typeCount = types;
+        postingLists.resize(types);
+
+        std::sort(results.begin(), results.end(), [&paths](const auto &a, const auto &b)
+                  { return paths[a.first] < paths[b.first]; });
+
+        size_t total = 0;
+        for (const auto &result : results)
+        {
+            total += result.second.occurrences.size();
+        }
+        fileIds.reserve(results.size());
+        fileBegin.reserve(results.size() + 1);
+        counts.assign(results.size() * types, 0);
+        offsets.reserve(total);
+        lineNumbers.reserve(total);
+        castTypes.reserve(total);
+        owners.reserve(total);
+
+        fileBegin.push_back(0);
+        for (uint32_t rank = 0; rank < results.size(); ++rank)
+        {
+            fileIds.push_back(results[rank].first);
+            for (const auto &occ : results[rank].second.occurrences)
+            {
+                postingLists[occ.castType].push_back(static_cast<uint32_t>(offsets.size()));
+                ++counts[rank * types + occ.castType];
+                offsets.push_back(occ.offset);
+                lineNumbers.push_back(occ.lineNumber);
+                castTypes.push_back(occ.castType);
+                owners.push_back(rank);
+            }
+            fileBegin.push_back(static_cast<uint32_t>(offsets.size()));
+        }
+    }
+
+    size_t fileCount() const
+    {
+        return fileIds.size();
+    }
+
+    uint32_t fileId(size_t file) const
+    {
+        return fileIds[file];
+    }
+
+    size_t begin(size_t file) const
+    {
+        return fileBegin[file];
+    }
+
+    size_t end(size_t file) const
+    {
+        return fileBegin[file + 1];
+    }
+
+    uint32_t count(size_t file, size_t type) const
+    {
+        return counts[file * typeCount + type];
+    }
+
+    // Occurrence indices of one cast type, ordered by file rank and line.
+    const std::vector<uint32_t> &postings(size_t type) const
+    {
+        return postingLists[type];
+    }
+
+    // Rank of the file an occurrence belongs to.
+    size_t owner(size_t occurrence) const
+    {
+        return owners[occurrence];
+    }
+
+    CastOccurrence occurrence(size_t i) const
+    {
+        return {offsets[i], fileIds[owners[i]], lineNumbers[i], castTypes[i]};
+    }
+};
+
+#endif // SCAN_INDEX_HPP
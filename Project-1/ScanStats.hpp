@@ -0,0 +1,119 @@
+#ifndef SCAN_STATS_HPP
+#define SCAN_STATS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define SCAN_STATS_HAS_RUSAGE 1
+#endif
+
+// Volume counters and stage timings of one scan. Every worker fills its own
+// ScanStats and they are summed once the workers have joined, so the stage
+// times are totals across workers, while elapsed is wall-clock time. Files
+// are memory-mapped, so page faults are charged to whichever stage first
+// touches the bytes (the hash with --cache, the lexer otherwise).
+struct ScanStats
+{
+    using Clock = std::chrono::steady_clock;
+
+    size_t workers = 1;
+    size_t readers = 0; // pipeline reader threads
+    size_t files = 0;   // files looked at
+    size_t scanned = 0; // files lexed and matched rather than taken from the cache
+    uint64_t bytes = 0; // bytes read
+
+    // seconds
+    double walk = 0;   // directory traversal
+    double io = 0;     // stat, open and content hash
+    double lex = 0;    // building the code image
+    double match = 0;  // cast matching
+    double output = 0; // formatting and writing streamed results
+    double index = 0;  // merging worker results, index build, cache save
+    double elapsed = 0;
+
+    // Seconds since start; start is moved to now, so consecutive calls time
+    // consecutive stages.
+    static double lap(Clock::time_point &start)
+    {
+        Clock::time_point now = Clock::now();
+        std::chrono::duration<double> seconds = now - start;
+        start = now;
+        return seconds.count();
+    }
+
+    // Peak resident set size of the process in KiB, or 0 where unknown.
+    static long peakResidentKilobytes()
+    {
+#ifdef SCAN_STATS_HAS_RUSAGE
+        struct rusage usage;
+        if (::getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+#else
+        return 0;
+#endif
+    }
+
+    void add(const ScanStats &other)
+    {
+        files += other.files;
+        scanned += other.scanned;
+        bytes += other.bytes;
+        walk += other.walk;
+        io += other.io;
+        lex += other.lex;
+        match += other.match;
+        output += other.output;
+        index += other.index;
+    }
+
+    void print(std::ostream &os) const
+    {
+        const double wall = elapsed > 0 ? elapsed : 1e-9;
+        const std::ios_base::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+
+        os << "\n=== Scan statistics ===\n"
+           << std::fixed << std::setprecision(1)
+           << "Files:       " << files << " (" << scanned << " scanned, " << files - scanned << " from cache)\n"
+           << "Bytes read:  " << bytes << "\n"
+           << "Wall time:   " << elapsed * 1e3 << " ms with " << workers << (workers == 1 ? " worker" : " workers");
+        if (readers)
+        {
+            os << " and " << readers << (readers == 1 ? " reader" : " readers");
+        }
+        os << "\n"
+           << "Throughput:  " << files / wall << " files/s, " << bytes / wall / 1e6 << " MB/s\n"
+           << "Stage time (ms, summed over workers):\n";
+        const struct
+        {
+            const char *name;
+            double seconds;
+        } stages[] = {{"walk", walk}, {"io", io}, {"lex", lex}, {"match", match}, {"output", output}, {"index", index}};
+        for (const auto &stage : stages)
+        {
+            os << "  " << std::left << std::setw(8) << stage.name << std::right << std::setw(10)
+               << stage.seconds * 1e3 << "\n";
+        }
+        if (long rss = peakResidentKilobytes())
+        {
+            os << "Peak RSS:    " << rss << " KiB\n";
+        }
+
+        os.flags(flags);
+        os.precision(precision);
+    }
+};
+
+#endif // SCAN_STATS_HPP
@@ -0,0 +1,144 @@
+#ifndef SOURCE_FILE_HPP
+#define SOURCE_FILE_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "string_view.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SOURCE_FILE_HAS_MMAP 1
+#endif
+
+// Read-only view of a source file. On POSIX systems the file is memory-mapped;
+// elsewhere (or if mapping fails) it is read into a buffer that is kept for
+// the next file. The contents are exposed as a project2::string_view into that
+// storage, so nothing is copied. One SourceFile is meant to be reused
+// for many files: its buffer only grows, so steady-state opens do not allocate.
+class SourceFile
+{
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    void *mapping_ = nullptr;
+    std::vector<char> buffer_;
+
+#ifdef SOURCE_FILE_HAS_MMAP
+    bool map(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+        bool ok = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+        if (ok && info.st_size > 0)
+        {
+            void *mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                ok = false;
+            }
+            else
+            {
+                ::madvise(mapping, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                mapping_ = mapping;
+                data_ = static_cast<const char *>(mapping);
+                size_ = static_cast<size_t>(info.st_size);
+            }
+        }
+        ::close(fd);
+        return ok;
+    }
+#endif
+
+    bool read(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        buffer_.clear();
+        char chunk[64 * 1024];
+        while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+        {
+            buffer_.insert(buffer_.end(), chunk, chunk + file.gcount());
+        }
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        return true;
+    }
+
+public:
+    SourceFile() = default;
+    SourceFile(const SourceFile &) = delete;
+    SourceFile &operator=(const SourceFile &) = delete;
+
+    ~SourceFile()
+    {
+        close();
+    }
+
+    bool open(const std::string &path)
+    {
+        close();
+#ifdef SOURCE_FILE_HAS_MMAP
+        bool ok = map(path);
+        if (!ok)
+        {
+            ok = read(path);
+        }
+#else
+        bool ok = read(path);
+#endif
+        return ok;
+    }
+
+    void close()
+    {
+#ifdef SOURCE_FILE_HAS_MMAP
+        if (mapping_)
+        {
+            ::munmap(mapping_, size_);
+        }
+#endif
+        mapping_ = nullptr;
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    // Faults the whole file in now, so that a later pass over contents()
+    // does not stall on the disk (or the network). Meant for a reader thread
+    // that runs ahead of the thread doing the scan.
+    void prefetch() const
+    {
+#ifdef SOURCE_FILE_HAS_MMAP
+        if (mapping_)
+        {
+            ::madvise(mapping_, size_, MADV_WILLNEED);
+            const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            const volatile char *bytes = data_;
+            for (size_t i = 0; i < size_; i += page)
+            {
+                (void)bytes[i];
+            }
+        }
+#endif
+    }
+
+    project2::string_view contents() const
+    {
+        return project2::string_view(data_, size_);
+    }
+};
+
+#endif // SOURCE_FILE_HPP
@@ -0,0 +1,66 @@
+#ifndef WORK_STEALING_QUEUE_HPP
+#define WORK_STEALING_QUEUE_HPP
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Task-index queue with one deque per worker. A worker takes work from the
+// front of its own deque and, once that is empty, steals from the back of the
+// other deques. Every deque has its own mutex, so workers only contend with
+// each other while stealing.
+class WorkStealingQueue
+{
+private:
+    struct alignas(64) Lane
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<Lane> lanes;
+
+public:
+    explicit WorkStealingQueue(size_t workers) : lanes(workers == 0 ? 1 : workers) {}
+
+    size_t workers() const { return lanes.size(); }
+
+    void push(size_t worker, size_t task)
+    {
+        Lane &lane = lanes[worker % lanes.size()];
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.tasks.push_back(task);
+    }
+
+    // Returns false once every deque is empty. Tasks are never added while the
+    // workers are running, so an empty sweep means the work is done.
+    bool pop(size_t worker, size_t &task)
+    {
+        {
+            Lane &own = lanes[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = own.tasks.front();
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < lanes.size(); ++i)
+        {
+            Lane &victim = lanes[(worker + i) % lanes.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif // WORK_STEALING_QUEUE_HPP
@@ -0,0 +1,228 @@
+// Micro-benchmark: CastMatcher against the std::regex path it replaced.
+//
+// Usage: cast_matcher_bench [lines] [repetitions]
+//
+// Runs over a synthetic corpus; both engines must report the same number of
+// (line, cast type) hits or the benchmark fails. A second table compares the
+// CodeLexer pass over the whole corpus with a memchr newline count, the
+// cheapest pass that still touches every byte.
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+#include "CastMatcher.hpp"
+#include "CodeLexer.hpp"
+
+namespace
+{
+    const std::vector<std::string> castTypes = {
+        "static_cast",
+        "dynamic_cast",
+        "const_cast",
+        "reinterpret_cast"};
+
+    std::vector<std::string> makeCorpus(size_t lineCount)
+    {
+        const std::vector<std::string> templates = {
+            "    int value = compute(a, b) + offset;",
+            "    double ratio = static_cast<double>(num) / den;",
+            "    // no casts on this line, just a comment about static_cast",
+            "    if (Derived* d = dynamic_cast<Derived*>(base)) {",
+            "    std::vector<std::map<int, std::string>> table;",
+            "    auto* raw = reinterpret_cast<const unsigned char*>(&header);",
+            "    for (size_t i = 0; i < items.size(); ++i) { total += items[i]; }",
+            "    char* buf = const_cast<char*>(str.c_str());",
+            "    auto n = static_cast<std::vector<int>::size_type>(count);",
+            "}",
+        };
+
+        std::vector<std::string> corpus;
+        corpus.reserve(lineCount);
+        for (size_t i = 0; i < lineCount; ++i)
+        {
+            corpus.push_back(templates[(i * 7) % templates.size()]);
+        }
+        return corpus;
+    }
+
+    // The original analyzeFile loop: one regex built per line and cast type.
+    size_t scanRegexPerLine(const std::vector<std::string> &corpus)
+    {
+        size_t hits = 0;
+        for (const auto &line : corpus)
+        {
+            for (const auto &castType : castTypes)
+            {
+                std::regex castPattern(castType + "\\s*<.*?>\\s*\\(");
+                if (std::regex_search(line, castPattern))
+                {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    }
+
+    // Regexes hoisted out of the loop, to separate compilation cost from
+    // matching cost.
+    size_t scanRegexPrecompiled(const std::vector<std::string> &corpus)
+    {
+        std::vector<std::regex> patterns;
+        for (const auto &castType : castTypes)
+        {
+            patterns.emplace_back(castType + "\\s*<.*?>\\s*\\(");
+        }
+
+        size_t hits = 0;
+        for (const auto &line : corpus)
+        {
+            for (const auto &pattern : patterns)
+            {
+                if (std::regex_search(line, pattern))
+                {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    }
+
+    size_t scanMatcher(const std::vector<std::string> &corpus)
+    {
+        CastMatcher matcher(castTypes);
+        size_t hits = 0;
+        for (const auto &line : corpus)
+        {
+            uint32_t found = 0;
+            matcher.scan(line.data(), line.data() + line.size(),
+                         [&found](size_t type, size_t)
+                         { found |= 1u << type; });
+            for (; found != 0; found &= found - 1)
+            {
+                ++hits;
+            }
+        }
+        return hits;
+    }
+
+    size_t countNewlines(const std::string &text)
+    {
+        size_t newlines = 0;
+        const char *p = text.data();
+        const char *end = p + text.size();
+        while ((p = static_cast<const char *>(std::memchr(p, '\n', static_cast<size_t>(end - p)))))
+        {
+            ++newlines;
+            ++p;
+        }
+        return newlines;
+    }
+
+    // Returns the number of bytes left as code, so the pass cannot be
+    // optimized away.
+    size_t stripCode(const std::string &text)
+    {
+        static CodeLexer lexer;
+        project2::string_view image = lexer.strip(project2::string_view(text.data(), text.size()));
+        size_t code = 0;
+        for (size_t i = 0; i < image.size(); i += 64)
+        {
+            code += image[i] != ' ';
+        }
+        return code;
+    }
+
+    template <typename Input, typename Scan>
+    double bestOf(size_t repetitions, const Input &corpus, Scan scan, size_t &hits)
+    {
+        double best = 0;
+        for (size_t r = 0; r < repetitions; ++r)
+        {
+            auto start = std::chrono::steady_clock::now();
+            hits = scan(corpus);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (r == 0 || elapsed.count() < best)
+            {
+                best = elapsed.count();
+            }
+        }
+        return best;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t lineCount = argc > 1 ? std::stoul(argv[1]) : 20000;
+    size_t repetitions = argc > 2 ? std::stoul(argv[2]) : 3;
+
+    std::vector<std::string> corpus = makeCorpus(lineCount);
+    size_t bytes = 0;
+    for (const auto &line : corpus)
+    {
+        bytes += line.size() + 1;
+    }
+
+    struct Result
+    {
+        const char *name;
+        double seconds;
+        size_t hits;
+    };
+    std::vector<Result> results;
+
+    size_t hits = 0;
+    double seconds = bestOf(repetitions, corpus, scanRegexPerLine, hits);
+    results.push_back({"regex (per line)", seconds, hits});
+    seconds = bestOf(repetitions, corpus, scanRegexPrecompiled, hits);
+    results.push_back({"regex (precompiled)", seconds, hits});
+    seconds = bestOf(repetitions, corpus, scanMatcher, hits);
+    results.push_back({"CastMatcher", seconds, hits});
+
+    std::cout << "Corpus: " << lineCount << " lines, " << bytes << " bytes, best of "
+              << repetitions << "\n\n";
+    std::cout << std::left << std::setw(22) << "engine" << std::right << std::setw(12) << "ms"
+              << std::setw(12) << "MB/s" << std::setw(10) << "hits" << std::setw(10) << "speedup" << "\n";
+    for (const auto &result : results)
+    {
+        std::cout << std::left << std::setw(22) << result.name << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(2) << result.seconds * 1e3
+                  << std::setw(12) << std::setprecision(1) << bytes / result.seconds / 1e6
+                  << std::setw(10) << result.hits
+                  << std::setw(9) << std::setprecision(1) << results.front().seconds / result.seconds << "x\n";
+    }
+
+    for (const auto &result : results)
+    {
+        if (result.hits != results.front().hits)
+        {
+            std::cerr << "Hit count mismatch: " << result.name << std::endl;
+            return 1;
+        }
+    }
+
+    std::string text;
+    text.reserve(bytes);
+    for (const auto &line : corpus)
+    {
+        text += line;
+        text += '\n';
+    }
+    double memchrSeconds = bestOf(repetitions, text, countNewlines, hits);
+    double lexerSeconds = bestOf(repetitions, text, stripCode, hits);
+
+    std::cout << "\n" << std::left << std::setw(22) << "pass" << std::right << std::setw(12) << "ms"
+              << std::setw(12) << "MB/s" << "\n";
+    std::cout << std::left << std::setw(22) << "memchr newlines" << std::right << std::fixed
+              << std::setw(12) << std::setprecision(2) << memchrSeconds * 1e3
+              << std::setw(12) << std::setprecision(1) << bytes / memchrSeconds / 1e6 << "\n";
+    std::cout << std::left << std::setw(22) << "CodeLexer" << std::right << std::fixed
+              << std::setw(12) << std::setprecision(2) << lexerSeconds * 1e3
+              << std::setw(12) << std::setprecision(1) << bytes / lexerSeconds / 1e6
+              << "  (" << std::setprecision(2) << lexerSeconds / memchrSeconds << "x memchr)\n";
+    return 0;
+}
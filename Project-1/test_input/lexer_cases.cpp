@@ -0,0 +1,31 @@
+#pragma message("static_cast<int>(x) in a directive is not code")
+#include <cstdio>
+
+// Casts inside the macro body are code.
+#define AS_INT(x) static_cast<int>(x)
+
+struct Base {
+    virtual ~Base() = default;
+};
+
+struct Derived : Base {
+};
+
+void lexerCases(Base* base) {
+    // static_cast<int>(commented) is ignored
+    /* so is reinterpret_cast<char*>(this)
+       spanning lines */
+    const char* text = "dynamic_cast<Derived*>(base) in a string";
+    const char* raw = R"x(const_cast<int*>(")x" in a raw string)x";
+    char quote = '"';
+    int million = 1'000'000 + static_cast<int>(2.5);
+    // a continued comment \
+    static_cast<long>(still_a_comment);
+    long wide = static_cast<long>
+        (million);
+    Derived* derived = dynamic_cast<
+        Derived*>(base);
+    int& same = const_cast<int&>(million);
+    std::printf("%s %s %c %ld %p %d %d\n", text, raw, quote, wide,
+                static_cast<void*>(derived), same, AS_INT(1.5));
+}
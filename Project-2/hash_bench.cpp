@@ -0,0 +1,131 @@
+// Micro-benchmark: std::hash<project2::string_view> against
+// std::hash<std::string>, and string_map lookups by string_view against
+// std::unordered_map<std::string, int> lookups that build a std::string key.
+//
+// Usage: hash_bench [keys] [repetitions]
+//
+// Both maps must find every key the same number of times or the benchmark
+// fails.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "include/string_map.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F>
+double best_seconds(std::size_t repetitions, F&& run) {
+    double best = 0;
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        const Clock::time_point start = Clock::now();
+        run();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (r == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+// Identifier-like keys of mixed lengths, all in one buffer so that lookups
+// can hand out views into it.
+std::string make_keys(std::size_t count, std::vector<project2::string_view>& views) {
+    static const char* const parts[] = {"config", "user", "session", "cache", "index", "request", "id", "timeout_ms"};
+    std::string buffer;
+    std::vector<std::size_t> bounds;
+    for (std::size_t i = 0; i < count; ++i) {
+        bounds.push_back(buffer.size());
+        buffer += parts[i % 8];
+        buffer += '.';
+        buffer += parts[(i / 8) % 8];
+        buffer += '.';
+        buffer += std::to_string(i);
+    }
+    bounds.push_back(buffer.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        views.emplace_back(buffer.data() + bounds[i], bounds[i + 1] - bounds[i]);
+    }
+    return buffer;
+}
+
+volatile std::size_t sink;
+
+void hash_table(std::size_t repetitions) {
+    std::cout << "hash throughput (GB/s)\n"
+              << std::setw(8) << "bytes" << std::setw(16) << "std::string" << std::setw(16) << "project2" << '\n';
+    for (std::size_t length : {8, 16, 32, 64, 256, 4096}) {
+        const std::size_t count = (std::size_t(1) << 24) / length;
+        // A few distinct inputs, so no hash can be hoisted out of the loop.
+        std::vector<std::string> texts;
+        std::vector<project2::string_view> views;
+        for (char c = 'a'; c < 'a' + 16; ++c) texts.emplace_back(length, c);
+        for (const std::string& text : texts) views.emplace_back(text);
+        const std::hash<std::string> std_hash;
+        const std::hash<project2::string_view> p2_hash;
+
+        const double std_seconds = best_seconds(repetitions, [&] {
+            std::size_t h = 0;
+            for (std::size_t i = 0; i < count; ++i) h += std_hash(texts[i & 15]);
+            sink = h;
+        });
+        const double p2_seconds = best_seconds(repetitions, [&] {
+            std::size_t h = 0;
+            for (std::size_t i = 0; i < count; ++i) h += p2_hash(views[i & 15]);
+            sink = h;
+        });
+        const double bytes = double(count) * double(length) / 1e9;
+        std::cout << std::setw(8) << length << std::fixed << std::setprecision(2)
+                  << std::setw(16) << bytes / std_seconds << std::setw(16) << bytes / p2_seconds << '\n';
+    }
+}
+
+bool lookup_table(std::size_t key_count, std::size_t repetitions) {
+    std::vector<project2::string_view> keys;
+    const std::string buffer = make_keys(key_count, keys);
+
+    std::unordered_map<std::string, int> std_map;
+    project2::string_map<int> p2_map;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        std_map.emplace(keys[i].to_string(), int(i));
+        p2_map.try_emplace(keys[i], int(i));
+    }
+
+    std::size_t std_hits = 0, p2_hits = 0;
+    const double std_seconds = best_seconds(repetitions, [&] {
+        std_hits = 0;
+        for (project2::string_view key : keys) std_hits += std_map.count(key.to_string());
+    });
+    const double p2_seconds = best_seconds(repetitions, [&] {
+        p2_hits = 0;
+        for (project2::string_view key : keys) p2_hits += p2_map.count(key);
+    });
+
+    std::cout << "\nlookup by string_view, " << key_count << " keys (ns/lookup)\n"
+              << std::fixed << std::setprecision(1)
+              << "  unordered_map<std::string>: " << std_seconds * 1e9 / double(keys.size()) << '\n'
+              << "  project2::string_map:       " << p2_seconds * 1e9 / double(keys.size()) << '\n';
+    if (std_hits != p2_hits || p2_hits != keys.size()) {
+        std::cerr << "hit counts differ: " << std_hits << " vs " << p2_hits << '\n';
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t key_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const std::size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    if (key_count == 0 || repetitions == 0) {
+        std::cerr << "usage: hash_bench [keys] [repetitions]\n";
+        return 1;
+    }
+    hash_table(repetitions);
+    return lookup_table(key_count, repetitions) ? 0 : 1;
+}
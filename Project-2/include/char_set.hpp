@@ -0,0 +1,61 @@
+#ifndef PROJECT2_CHAR_SET_HPP
+#define PROJECT2_CHAR_SET_HPP
+
+// A set of byte values for the find_first_of / find_last_of family.
+//
+// Membership is a 256-bit bitmap. Alongside it the set keeps two 16-byte
+// tables indexed by the low nibble of a byte, whose bit h says whether the
+// byte with high nibble h (0-7 in the first table, 8-15 in the second) is in
+// the set; a SIMD classifier tests 16 or 32 bytes at once with a couple of
+// byte shuffles over them (see detail/char_class.hpp). Everything is built in
+// the constructor, which is constexpr, so a set of delimiters can be a
+// compile-time constant and reused for every search.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace project2 {
+
+class char_set {
+public:
+    constexpr char_set() noexcept = default;
+
+    constexpr char_set(const char* s, std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; ++i) insert(s[i]);
+    }
+
+    // From a NUL-terminated string.
+    explicit constexpr char_set(const char* s) noexcept {
+        for (; s && *s; ++s) insert(*s);
+    }
+
+    constexpr void insert(char c) noexcept {
+        const unsigned u = static_cast<unsigned char>(c);
+        bits_[u >> 6] |= std::uint64_t(1) << (u & 63);
+        const unsigned high = u >> 4;
+        if (high < 8) {
+            low_rows_[u & 15] = static_cast<unsigned char>(low_rows_[u & 15] | (1u << high));
+        } else {
+            high_rows_[u & 15] = static_cast<unsigned char>(high_rows_[u & 15] | (1u << (high - 8)));
+        }
+    }
+
+    constexpr bool contains(char c) const noexcept {
+        const unsigned u = static_cast<unsigned char>(c);
+        return (bits_[u >> 6] >> (u & 63)) & 1;
+    }
+
+    // Classifier tables: bit h of low_rows()[n] is set if (h << 4 | n) is in
+    // the set, and bit h of high_rows()[n] if ((h + 8) << 4 | n) is.
+    constexpr const unsigned char* low_rows() const noexcept { return low_rows_; }
+    constexpr const unsigned char* high_rows() const noexcept { return high_rows_; }
+
+private:
+    std::uint64_t bits_[4] = {};
+    unsigned char low_rows_[16] = {};
+    unsigned char high_rows_[16] = {};
+};
+
+} // namespace project2
+
+#endif // PROJECT2_CHAR_SET_HPP
@@ -0,0 +1,171 @@
+#ifndef PROJECT2_DETAIL_CHAR_CLASS_HPP
+#define PROJECT2_DETAIL_CHAR_CLASS_HPP
+
+// Character-class scan kernels behind find_first_of / find_last_of and the
+// *_not_of variants.
+//
+// A block of bytes is classified with the nibble tables of a char_set: the
+// low nibble of each byte selects a row from both tables with pshufb, the
+// sign bit picks one of the two rows, and a third shuffle turns the high
+// nibble into the bit to test in that row. That classifies 32 bytes per step
+// with AVX2 and 16 with SSSE3, whatever the size of the set; without either,
+// or for short ranges, the bitmap is tested one byte at a time.
+
+#include <cstddef>
+#include "simd.hpp"
+#include "../char_set.hpp"
+
+namespace project2 {
+namespace detail {
+
+// Ranges shorter than this are scanned with the bitmap.
+constexpr std::size_t char_class_simd_min = 16;
+
+// First index in h[0, n) whose byte is in set (or, with negate, is not).
+constexpr std::size_t find_in_set_scalar(const char* h, std::size_t n, const char_set& set, bool negate) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (set.contains(h[i]) != negate) return i;
+    }
+    return search_npos;
+}
+
+// Last index at or before limit whose byte is in set (or is not).
+constexpr std::size_t rfind_in_set_scalar(const char* h, std::size_t limit, const char_set& set, bool negate) noexcept {
+    for (std::size_t i = limit + 1; i > 0; --i) {
+        if (set.contains(h[i - 1]) != negate) return i - 1;
+    }
+    return search_npos;
+}
+
+#ifdef PROJECT2_HAS_SSSE3
+struct ssse3_classifier {
+    __m128i low_rows;
+    __m128i high_rows;
+    __m128i bit_of_high; // 1 << (h & 7) for every high nibble h
+    __m128i nibble;
+
+    PROJECT2_TARGET_SSSE3
+    explicit ssse3_classifier(const char_set& set) noexcept
+        : low_rows(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.low_rows()))),
+          high_rows(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.high_rows()))),
+          bit_of_high(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128)),
+          nibble(_mm_set1_epi8(0x0F)) {}
+
+    // Bit i is set if byte i of the block is in the set.
+    PROJECT2_TARGET_SSSE3
+    unsigned mask(const char* p) const noexcept {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i low = _mm_and_si128(x, nibble);
+        const __m128i high = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+        const __m128i upper = _mm_cmplt_epi8(x, _mm_setzero_si128()); // byte >= 0x80
+        const __m128i row = _mm_or_si128(_mm_and_si128(upper, _mm_shuffle_epi8(high_rows, low)),
+                                         _mm_andnot_si128(upper, _mm_shuffle_epi8(low_rows, low)));
+        const __m128i bit = _mm_shuffle_epi8(bit_of_high, high);
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit)));
+    }
+};
+
+PROJECT2_TARGET_SSSE3
+inline std::size_t find_in_set_ssse3(const char* h, std::size_t n, const char_set& set, bool negate) noexcept {
+    const ssse3_classifier classify(set);
+    const unsigned flip = negate ? 0xFFFFu : 0u;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        if (const unsigned mask = classify.mask(h + i) ^ flip) return i + lowest_bit(mask);
+    }
+    const std::size_t r = find_in_set_scalar(h + i, n - i, set, negate);
+    return r == search_npos ? r : r + i;
+}
+
+PROJECT2_TARGET_SSSE3
+inline std::size_t rfind_in_set_ssse3(const char* h, std::size_t limit, const char_set& set, bool negate) noexcept {
+    const ssse3_classifier classify(set);
+    const unsigned flip = negate ? 0xFFFFu : 0u;
+    std::size_t top = limit;
+    while (top >= 15) {
+        const std::size_t j = top - 15;
+        if (const unsigned mask = classify.mask(h + j) ^ flip) return j + highest_bit(mask);
+        if (j == 0) return search_npos;
+        top = j - 1;
+    }
+    return rfind_in_set_scalar(h, top, set, negate);
+}
+#endif
+
+#ifdef PROJECT2_HAS_AVX2
+struct avx2_classifier {
+    __m256i low_rows;
+    __m256i high_rows;
+    __m256i bit_of_high;
+    __m256i nibble;
+
+    PROJECT2_TARGET_AVX2
+    explicit avx2_classifier(const char_set& set) noexcept
+        : low_rows(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.low_rows())))),
+          high_rows(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.high_rows())))),
+          bit_of_high(_mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                       1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128)),
+          nibble(_mm256_set1_epi8(0x0F)) {}
+
+    PROJECT2_TARGET_AVX2
+    unsigned mask(const char* p) const noexcept {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i low = _mm256_and_si256(x, nibble);
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+        const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low_rows, low), _mm256_shuffle_epi8(high_rows, low), x);
+        const __m256i bit = _mm256_shuffle_epi8(bit_of_high, high);
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit)));
+    }
+};
+
+PROJECT2_TARGET_AVX2
+inline std::size_t find_in_set_avx2(const char* h, std::size_t n, const char_set& set, bool negate) noexcept {
+    const avx2_classifier classify(set);
+    const unsigned flip = negate ? 0xFFFFFFFFu : 0u;
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        if (const unsigned mask = classify.mask(h + i) ^ flip) return i + lowest_bit(mask);
+    }
+    const std::size_t r = find_in_set_ssse3(h + i, n - i, set, negate);
+    return r == search_npos ? r : r + i;
+}
+
+PROJECT2_TARGET_AVX2
+inline std::size_t rfind_in_set_avx2(const char* h, std::size_t limit, const char_set& set, bool negate) noexcept {
+    const avx2_classifier classify(set);
+    const unsigned flip = negate ? 0xFFFFFFFFu : 0u;
+    std::size_t top = limit;
+    while (top >= 31) {
+        const std::size_t j = top - 31;
+        if (const unsigned mask = classify.mask(h + j) ^ flip) return j + highest_bit(mask);
+        if (j == 0) return search_npos;
+        top = j - 1;
+    }
+    return rfind_in_set_ssse3(h, top, set, negate);
+}
+#endif
+
+inline std::size_t find_in_set(const char* h, std::size_t n, const char_set& set, bool negate) noexcept {
+#ifdef PROJECT2_HAS_SSSE3
+    if (n >= char_class_simd_min) {
+        if (cpu_has_avx2()) return find_in_set_avx2(h, n, set, negate);
+        if (cpu_has_ssse3()) return find_in_set_ssse3(h, n, set, negate);
+    }
+#endif
+    return find_in_set_scalar(h, n, set, negate);
+}
+
+inline std::size_t rfind_in_set(const char* h, std::size_t limit, const char_set& set, bool negate) noexcept {
+#ifdef PROJECT2_HAS_SSSE3
+    if (limit + 1 >= char_class_simd_min) {
+        if (cpu_has_avx2()) return rfind_in_set_avx2(h, limit, set, negate);
+        if (cpu_has_ssse3()) return rfind_in_set_ssse3(h, limit, set, negate);
+    }
+#endif
+    return rfind_in_set_scalar(h, limit, set, negate);
+}
+
+} // namespace detail
+} // namespace project2
+
+#endif // PROJECT2_DETAIL_CHAR_CLASS_HPP
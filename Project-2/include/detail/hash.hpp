@@ -0,0 +1,149 @@
+#ifndef PROJECT2_DETAIL_HASH_HPP
+#define PROJECT2_DETAIL_HASH_HPP
+
+// Byte hashing behind std::hash<project2::string_view> and string_hash.
+//
+// The construction follows wyhash: 64-bit words are xored with constants and
+// folded by a 64x64->128-bit multiply whose halves are xored together. Inputs
+// longer than 48 bytes go through three independent 16-byte lanes per step so
+// the multiplies overlap; shorter ones take one or two overlapping loads with
+// no loop at all, which keeps the short keys of a typical map cheap. The
+// result is well mixed in all 64 bits, so bucket selection by modulo or by
+// mask both work. It is not a cryptographic hash.
+//
+// Everything is constexpr, and words are read in little-endian order on
+// every target, so a key hashed at compile time gets the same value as at
+// run time on any machine.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "simd.hpp"
+
+namespace project2 {
+namespace detail {
+
+constexpr std::uint64_t hash_secret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6dbull,
+                                          0x589965cc75374cc3ull};
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 hash_uint128; // __extension__ keeps -Wpedantic quiet
+#endif
+
+constexpr void hash_multiply_portable(std::uint64_t& a, std::uint64_t& b) noexcept {
+    const std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+    const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const std::uint64_t t = rl + (rm0 << 32);
+    std::uint64_t carry = t < rl;
+    const std::uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+}
+
+constexpr void hash_multiply(std::uint64_t& a, std::uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    const hash_uint128 r = static_cast<hash_uint128>(a) * b;
+    a = static_cast<std::uint64_t>(r);
+    b = static_cast<std::uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64) && defined(PROJECT2_HAS_CONSTANT_EVALUATED)
+    if (is_constant_evaluated()) {
+        hash_multiply_portable(a, b);
+    } else {
+        a = _umul128(a, b, &b);
+    }
+#else
+    hash_multiply_portable(a, b);
+#endif
+}
+
+constexpr std::uint64_t hash_mix(std::uint64_t a, std::uint64_t b) noexcept {
+    hash_multiply(a, b);
+    return a ^ b;
+}
+
+// Little-endian words. At run time a plain load, byte-swapped on big-endian
+// targets; at compile time (or without is_constant_evaluated) assembled from
+// bytes, which gives the same value.
+constexpr std::uint64_t hash_read4(const char* p) noexcept {
+#ifdef PROJECT2_HAS_CONSTANT_EVALUATED
+    if (!is_constant_evaluated()) {
+        std::uint32_t v = 0;
+        std::memcpy(&v, p, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        v = __builtin_bswap32(v);
+#endif
+        return v;
+    }
+#endif
+    return std::uint64_t(static_cast<unsigned char>(p[0])) | std::uint64_t(static_cast<unsigned char>(p[1])) << 8 |
+           std::uint64_t(static_cast<unsigned char>(p[2])) << 16 | std::uint64_t(static_cast<unsigned char>(p[3])) << 24;
+}
+
+constexpr std::uint64_t hash_read8(const char* p) noexcept {
+#ifdef PROJECT2_HAS_CONSTANT_EVALUATED
+    if (!is_constant_evaluated()) {
+        std::uint64_t v = 0;
+        std::memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        v = __builtin_bswap64(v);
+#endif
+        return v;
+    }
+#endif
+    return hash_read4(p) | hash_read4(p + 4) << 32;
+}
+
+constexpr std::uint64_t hash_finish(std::uint64_t a, std::uint64_t b, std::uint64_t seed, std::size_t len) noexcept {
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_multiply(a, b);
+    return hash_mix(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]);
+}
+
+// More than 16 bytes; seed already mixed in by hash_bytes.
+constexpr std::uint64_t hash_bytes_long(const char* p, std::size_t len, std::uint64_t seed) noexcept {
+    const std::uint64_t* s = hash_secret;
+    std::size_t i = len;
+    if (i > 48) {
+        std::uint64_t lane1 = seed, lane2 = seed;
+        do {
+            seed = hash_mix(hash_read8(p) ^ s[1], hash_read8(p + 8) ^ seed);
+            lane1 = hash_mix(hash_read8(p + 16) ^ s[2], hash_read8(p + 24) ^ lane1);
+            lane2 = hash_mix(hash_read8(p + 32) ^ s[3], hash_read8(p + 40) ^ lane2);
+            p += 48;
+            i -= 48;
+        } while (i > 48);
+        seed ^= lane1 ^ lane2;
+    }
+    while (i > 16) {
+        seed = hash_mix(hash_read8(p) ^ s[1], hash_read8(p + 8) ^ seed);
+        p += 16;
+        i -= 16;
+    }
+    // The last 16 bytes, overlapping what the loop already consumed.
+    return hash_finish(hash_read8(p + i - 16), hash_read8(p + i - 8), seed, len);
+}
+
+// Keys of up to 16 bytes, the common case for maps, take this inline path
+// without a loop.
+constexpr std::uint64_t hash_bytes(const char* p, std::size_t len, std::uint64_t seed = 0) noexcept {
+    seed ^= hash_secret[0];
+    if (len > 16) return hash_bytes_long(p, len, seed);
+    std::uint64_t a = 0, b = 0;
+    if (len >= 4) {
+        // Two possibly overlapping pairs of 4-byte loads cover 4..16 bytes.
+        const std::size_t step = (len >> 3) << 2;
+        a = (hash_read4(p) << 32) | hash_read4(p + step);
+        b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - step);
+    } else if (len > 0) {
+        a = std::uint64_t(static_cast<unsigned char>(p[0])) << 16 |
+            std::uint64_t(static_cast<unsigned char>(p[len >> 1])) << 8 | static_cast<unsigned char>(p[len - 1]);
+    }
+    return hash_finish(a, b, seed, len);
+}
+
+} // namespace detail
+} // namespace project2
+
+#endif // PROJECT2_DETAIL_HASH_HPP
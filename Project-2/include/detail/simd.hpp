@@ -0,0 +1,99 @@
+#ifndef PROJECT2_DETAIL_SIMD_HPP
+#define PROJECT2_DETAIL_SIMD_HPP
+
+// Instruction-set detection shared by the search kernels. SSE2 is used
+// wherever the compiler targets it. SSSE3 and AVX2 kernels are compiled
+// through target attributes (GCC and Clang on x86) and only called when the
+// CPU reports the feature, so one binary runs on any x86-64 machine.
+//
+// None of the kernels can run at compile time, so constexpr callers also
+// check is_constant_evaluated() and take a plain loop when it is true.
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PROJECT2_HAS_SSE2 1
+#endif
+
+#if defined(PROJECT2_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PROJECT2_HAS_SSSE3 1
+#define PROJECT2_HAS_AVX2 1
+#define PROJECT2_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define PROJECT2_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// C++17 has no std::is_constant_evaluated, but GCC 9+, Clang 9+ and MSVC
+// 19.25+ provide the builtin behind it in any language mode.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define PROJECT2_HAS_CONSTANT_EVALUATED 1
+#endif
+#elif (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define PROJECT2_HAS_CONSTANT_EVALUATED 1
+#endif
+
+namespace project2 {
+namespace detail {
+
+constexpr std::size_t search_npos = static_cast<std::size_t>(-1);
+
+// True while evaluating a constant expression. Without the builtin it is
+// always false: everything still works at run time, and only the searches
+// are unavailable at compile time.
+constexpr bool is_constant_evaluated() noexcept {
+#ifdef PROJECT2_HAS_CONSTANT_EVALUATED
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+inline unsigned lowest_bit(unsigned mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned highest_bit(unsigned mask) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+}
+
+// Checked once per process.
+inline bool cpu_has_avx2() noexcept {
+#ifdef PROJECT2_HAS_AVX2
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+#else
+    return false;
+#endif
+}
+
+inline bool cpu_has_ssse3() noexcept {
+#ifdef PROJECT2_HAS_SSSE3
+    static const bool has = __builtin_cpu_supports("ssse3");
+    return has;
+#else
+    return false;
+#endif
+}
+
+} // namespace detail
+} // namespace project2
+
+#endif // PROJECT2_DETAIL_SIMD_HPP
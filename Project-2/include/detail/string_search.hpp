@@ -0,0 +1,435 @@
+#ifndef PROJECT2_DETAIL_STRING_SEARCH_HPP
+#define PROJECT2_DETAIL_STRING_SEARCH_HPP
+
+// Substring search kernels behind string_view::find / rfind.
+//
+// Short needles use the first-and-last-byte filter: a block of haystack
+// positions is compared against the needle's first byte, the block shifted by
+// needle length - 1 against its last byte, and only positions where both match
+// are verified with memcmp. That runs on 32-byte AVX2 blocks when the CPU has
+// AVX2 (checked once at run time), on 16-byte SSE2 blocks otherwise, and as a
+// memchr-driven scalar loop where neither is available. Long needles use
+// Boyer-Moore-Horspool, whose skips grow with the needle length.
+//
+// All functions take raw (pointer, length) pairs and return an offset into
+// the haystack or npos; the caller handles pos and the empty-needle cases.
+
+#include <cstddef>
+#include <cstring>
+#include "simd.hpp"
+
+namespace project2 {
+namespace detail {
+
+// Needles at least this long are searched with Horspool. Below it the SIMD
+// filter is faster; above it Horspool's skips (up to the needle length) win.
+constexpr std::size_t horspool_threshold = 128;
+
+// Rough frequency rank of a byte in source code and text, higher is more
+// common. Used to pick the needle bytes the SIMD filter compares.
+constexpr int byte_rank(unsigned char c) noexcept {
+    return c == ' ' ? 255
+         : (c == 'e' || c == 't' || c == 'a' || c == 'o' || c == 'i' || c == 'n' || c == 's' || c == 'r') ? 220
+         : (c == '\n' || c == '\t') ? 200
+         : (c >= 'a' && c <= 'z') ? 180
+         : (c == '_' || c == '(' || c == ')' || c == ';' || c == ',' || c == '.' || c == '=' || c == '"') ? 160
+         : (c >= '0' && c <= '9') ? 140
+         : (c >= 'A' && c <= 'Z') ? 120
+         : (c >= 0x21 && c <= 0x7e) ? 100
+         : 20;
+}
+
+// Positions lo < hi of the two rarest bytes of s[0, m), m >= 2; the second
+// is taken among bytes that differ from the first where possible, since two
+// equal bytes filter no better than one.
+inline void rare_pair(const char* s, std::size_t m, std::size_t& lo, std::size_t& hi) noexcept {
+    std::size_t a = 0;
+    for (std::size_t k = 1; k < m; ++k) {
+        if (byte_rank(static_cast<unsigned char>(s[k])) < byte_rank(static_cast<unsigned char>(s[a]))) a = k;
+    }
+    std::size_t b = a == 0 ? 1 : 0;
+    for (std::size_t k = 0; k < m; ++k) {
+        if (k == a) continue;
+        const bool b_same = s[b] == s[a];
+        const bool k_same = s[k] == s[a];
+        if ((b_same && !k_same) ||
+            (b_same == k_same && byte_rank(static_cast<unsigned char>(s[k])) < byte_rank(static_cast<unsigned char>(s[b])))) {
+            b = k;
+        }
+    }
+    lo = a < b ? a : b;
+    hi = a < b ? b : a;
+}
+
+// ---- scalar ---------------------------------------------------------------
+
+// memchr finds candidates for the first byte; the last byte is checked
+// before the full compare.
+inline std::size_t find_scalar(const char* h, std::size_t n, const char* s, std::size_t m) noexcept {
+    if (m > n) return search_npos;
+    const char* const last_start = h + (n - m);
+    const char* p = h;
+    while (p <= last_start) {
+        p = static_cast<const char*>(std::memchr(p, s[0], static_cast<std::size_t>(last_start - p) + 1));
+        if (!p) return search_npos;
+        if (p[m - 1] == s[m - 1] && std::memcmp(p, s, m) == 0) return static_cast<std::size_t>(p - h);
+        ++p;
+    }
+    return search_npos;
+}
+
+// Last match starting at or before limit (limit <= n - m).
+inline std::size_t rfind_scalar(const char* h, std::size_t limit, const char* s, std::size_t m) noexcept {
+    for (std::size_t i = limit + 1; i > 0; --i) {
+        const char* p = h + (i - 1);
+        if (p[0] == s[0] && p[m - 1] == s[m - 1] && std::memcmp(p, s, m) == 0) return i - 1;
+    }
+    return search_npos;
+}
+
+constexpr std::size_t rfind_byte_scalar(const char* h, std::size_t limit, char c) noexcept {
+    for (std::size_t i = limit + 1; i > 0; --i) {
+        if (h[i - 1] == c) return i - 1;
+    }
+    return search_npos;
+}
+
+// ---- several needles ------------------------------------------------------
+
+// One needle of a multi-needle search, with the positions of its two filter
+// bytes (lo == hi for a one-byte needle).
+struct filtered_needle {
+    const char* s;
+    std::size_t m;
+    std::size_t lo;
+    std::size_t hi;
+};
+
+// Needle sets up to this size are filtered with SIMD, one compare pair per
+// needle and block.
+constexpr std::size_t multi_filter_limit = 8;
+
+// Leftmost match of any needle in h[0, n); of needles matching at the same
+// position the one listed first wins, and which is set to its index.
+inline std::size_t find_any_scalar(const char* h, std::size_t n, const filtered_needle* needles,
+                                   std::size_t count, std::size_t& which) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t k = 0; k < count; ++k) {
+            const filtered_needle& needle = needles[k];
+            if (needle.m <= n - i && h[i + needle.lo] == needle.s[needle.lo] &&
+                std::memcmp(h + i, needle.s, needle.m) == 0) {
+                which = k;
+                return i;
+            }
+        }
+    }
+    return search_npos;
+}
+
+// ---- Boyer-Moore-Horspool -------------------------------------------------
+
+// Shift tables for one needle; shifts are capped at the needle length.
+struct horspool_table {
+    std::size_t shift[256];
+
+    // Forward search: shift by the distance from the window's last byte to
+    // its last occurrence in needle[0, m-1).
+    void build_forward(const char* s, std::size_t m) noexcept {
+        for (std::size_t c = 0; c < 256; ++c) shift[c] = m;
+        for (std::size_t k = 0; k + 1 < m; ++k) shift[static_cast<unsigned char>(s[k])] = m - 1 - k;
+    }
+
+    // Backward search: shift by the distance from the window's first byte to
+    // its first occurrence in needle[1, m).
+    void build_backward(const char* s, std::size_t m) noexcept {
+        for (std::size_t c = 0; c < 256; ++c) shift[c] = m;
+        for (std::size_t k = m - 1; k > 0; --k) shift[static_cast<unsigned char>(s[k])] = k;
+    }
+};
+
+inline std::size_t find_horspool(const char* h, std::size_t n, const char* s, std::size_t m,
+                                 const horspool_table& table) noexcept {
+    if (m > n) return search_npos;
+    const char last = s[m - 1];
+    for (std::size_t i = 0; i <= n - m;) {
+        const char c = h[i + m - 1];
+        if (c == last && std::memcmp(h + i, s, m - 1) == 0) return i;
+        i += table.shift[static_cast<unsigned char>(c)];
+    }
+    return search_npos;
+}
+
+inline std::size_t rfind_horspool(const char* h, std::size_t limit, const char* s, std::size_t m,
+                                  const horspool_table& table) noexcept {
+    const char first = s[0];
+    for (std::size_t i = limit;;) {
+        const char c = h[i];
+        if (c == first && std::memcmp(h + i + 1, s + 1, m - 1) == 0) return i;
+        const std::size_t step = table.shift[static_cast<unsigned char>(c)];
+        if (step > i) return search_npos;
+        i -= step;
+    }
+}
+
+// ---- SSE2 -----------------------------------------------------------------
+
+#ifdef PROJECT2_HAS_SSE2
+// The filter compares needle bytes lo < hi (by default the first and the
+// last); m >= 2.
+inline std::size_t find_sse2(const char* h, std::size_t n, const char* s, std::size_t m,
+                             std::size_t lo = 0, std::size_t hi = 0) noexcept {
+    if (m > n) return search_npos;
+    if (hi == 0) hi = m - 1;
+    const __m128i first = _mm_set1_epi8(s[lo]);
+    const __m128i last = _mm_set1_epi8(s[hi]);
+    std::size_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + lo));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + hi));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        while (mask) {
+            const unsigned bit = lowest_bit(mask);
+            if (std::memcmp(h + i + bit, s, m) == 0) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    const std::size_t r = find_scalar(h + i, n - i, s, m);
+    return r == search_npos ? r : r + i;
+}
+
+// m >= 2, limit <= n - m.
+inline std::size_t rfind_sse2(const char* h, std::size_t limit, const char* s, std::size_t m,
+                              std::size_t lo = 0, std::size_t hi = 0) noexcept {
+    if (hi == 0) hi = m - 1;
+    const __m128i first = _mm_set1_epi8(s[lo]);
+    const __m128i last = _mm_set1_epi8(s[hi]);
+    std::size_t top = limit; // highest start not yet examined
+    while (top >= 15) {
+        const std::size_t j = top - 15;
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + j + lo));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + j + hi));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        while (mask) {
+            const unsigned bit = highest_bit(mask);
+            if (std::memcmp(h + j + bit, s, m) == 0) return j + bit;
+            mask &= ~(1u << bit);
+        }
+        if (j == 0) return search_npos;
+        top = j - 1;
+    }
+    return rfind_scalar(h, top, s, m);
+}
+
+inline std::size_t rfind_byte_sse2(const char* h, std::size_t limit, char c) noexcept {
+    const __m128i needle = _mm_set1_epi8(c);
+    std::size_t top = limit;
+    while (top >= 15) {
+        const std::size_t j = top - 15;
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + j));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, needle)));
+        if (mask) return j + highest_bit(mask);
+        if (j == 0) return search_npos;
+        top = j - 1;
+    }
+    return rfind_byte_scalar(h, top, c);
+}
+
+// count <= multi_filter_limit; max_m is the longest needle.
+inline std::size_t find_any_sse2(const char* h, std::size_t n, const filtered_needle* needles, std::size_t count,
+                                 std::size_t max_m, std::size_t& which) noexcept {
+    __m128i lo_bytes[multi_filter_limit];
+    __m128i hi_bytes[multi_filter_limit];
+    for (std::size_t k = 0; k < count; ++k) {
+        lo_bytes[k] = _mm_set1_epi8(needles[k].s[needles[k].lo]);
+        hi_bytes[k] = _mm_set1_epi8(needles[k].s[needles[k].hi]);
+    }
+    std::size_t i = 0;
+    for (; i + max_m - 1 + 16 <= n; i += 16) {
+        unsigned masks[multi_filter_limit];
+        unsigned any = 0;
+        for (std::size_t k = 0; k < count; ++k) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + needles[k].lo));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + needles[k].hi));
+            masks[k] = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, lo_bytes[k]), _mm_cmpeq_epi8(b, hi_bytes[k]))));
+            any |= masks[k];
+        }
+        while (any) {
+            const unsigned bit = lowest_bit(any);
+            for (std::size_t k = 0; k < count; ++k) {
+                if ((masks[k] >> bit & 1u) && std::memcmp(h + i + bit, needles[k].s, needles[k].m) == 0) {
+                    which = k;
+                    return i + bit;
+                }
+            }
+            any &= any - 1;
+        }
+    }
+    const std::size_t r = find_any_scalar(h + i, n - i, needles, count, which);
+    return r == search_npos ? r : r + i;
+}
+#endif
+
+// ---- AVX2 -----------------------------------------------------------------
+
+#ifdef PROJECT2_HAS_AVX2
+PROJECT2_TARGET_AVX2
+inline std::size_t find_avx2(const char* h, std::size_t n, const char* s, std::size_t m,
+                             std::size_t lo = 0, std::size_t hi = 0) noexcept {
+    if (m > n) return search_npos;
+    if (hi == 0) hi = m - 1;
+    const __m256i first = _mm256_set1_epi8(s[lo]);
+    const __m256i last = _mm256_set1_epi8(s[hi]);
+    std::size_t i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + lo));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + hi));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+        while (mask) {
+            const unsigned bit = lowest_bit(mask);
+            if (std::memcmp(h + i + bit, s, m) == 0) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    const std::size_t r = find_sse2(h + i, n - i, s, m, lo, hi);
+    return r == search_npos ? r : r + i;
+}
+
+PROJECT2_TARGET_AVX2
+inline std::size_t rfind_avx2(const char* h, std::size_t limit, const char* s, std::size_t m,
+                              std::size_t lo = 0, std::size_t hi = 0) noexcept {
+    if (hi == 0) hi = m - 1;
+    const __m256i first = _mm256_set1_epi8(s[lo]);
+    const __m256i last = _mm256_set1_epi8(s[hi]);
+    std::size_t top = limit;
+    while (top >= 31) {
+        const std::size_t j = top - 31;
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + j + lo));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + j + hi));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+        while (mask) {
+            const unsigned bit = highest_bit(mask);
+            if (std::memcmp(h + j + bit, s, m) == 0) return j + bit;
+            mask &= ~(1u << bit);
+        }
+        if (j == 0) return search_npos;
+        top = j - 1;
+    }
+    return rfind_sse2(h, top, s, m, lo, hi);
+}
+
+PROJECT2_TARGET_AVX2
+inline std::size_t find_any_avx2(const char* h, std::size_t n, const filtered_needle* needles, std::size_t count,
+                                 std::size_t max_m, std::size_t& which) noexcept {
+    __m256i lo_bytes[multi_filter_limit];
+    __m256i hi_bytes[multi_filter_limit];
+    for (std::size_t k = 0; k < count; ++k) {
+        lo_bytes[k] = _mm256_set1_epi8(needles[k].s[needles[k].lo]);
+        hi_bytes[k] = _mm256_set1_epi8(needles[k].s[needles[k].hi]);
+    }
+    std::size_t i = 0;
+    for (; i + max_m - 1 + 32 <= n; i += 32) {
+        unsigned masks[multi_filter_limit];
+        unsigned any = 0;
+        for (std::size_t k = 0; k < count; ++k) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + needles[k].lo));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + needles[k].hi));
+            masks[k] = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, lo_bytes[k]), _mm256_cmpeq_epi8(b, hi_bytes[k]))));
+            any |= masks[k];
+        }
+        while (any) {
+            const unsigned bit = lowest_bit(any);
+            for (std::size_t k = 0; k < count; ++k) {
+                if ((masks[k] >> bit & 1u) && std::memcmp(h + i + bit, needles[k].s, needles[k].m) == 0) {
+                    which = k;
+                    return i + bit;
+                }
+            }
+            any &= any - 1;
+        }
+    }
+    const std::size_t r = find_any_sse2(h + i, n - i, needles, count, max_m, which);
+    return r == search_npos ? r : r + i;
+}
+#endif
+
+// ---- constant evaluation --------------------------------------------------
+
+// Plain loops for constexpr callers; see is_constant_evaluated().
+constexpr bool equal_constant(const char* a, const char* b, std::size_t m) noexcept {
+    for (std::size_t i = 0; i < m; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+constexpr std::size_t find_constant(const char* h, std::size_t n, const char* s, std::size_t m) noexcept {
+    if (m > n) return search_npos;
+    for (std::size_t i = 0; i + m <= n; ++i) {
+        if (equal_constant(h + i, s, m)) return i;
+    }
+    return search_npos;
+}
+
+constexpr std::size_t rfind_constant(const char* h, std::size_t limit, const char* s, std::size_t m) noexcept {
+    for (std::size_t i = limit + 1; i > 0; --i) {
+        if (equal_constant(h + i - 1, s, m)) return i - 1;
+    }
+    return search_npos;
+}
+
+// ---- dispatch -------------------------------------------------------------
+
+// First occurrence of s[0, m) in h[0, n); m >= 1.
+inline std::size_t find(const char* h, std::size_t n, const char* s, std::size_t m) noexcept {
+    if (m > n) return search_npos;
+    if (m == 1) {
+        const void* p = std::memchr(h, s[0], n);
+        return p ? static_cast<std::size_t>(static_cast<const char*>(p) - h) : search_npos;
+    }
+    if (m >= horspool_threshold) {
+        horspool_table table;
+        table.build_forward(s, m);
+        return find_horspool(h, n, s, m, table);
+    }
+#if defined(PROJECT2_HAS_AVX2)
+    if (cpu_has_avx2()) return find_avx2(h, n, s, m);
+#endif
+#if defined(PROJECT2_HAS_SSE2)
+    return find_sse2(h, n, s, m);
+#else
+    return find_scalar(h, n, s, m);
+#endif
+}
+
+// Last occurrence of c at or before limit.
+inline std::size_t rfind_byte(const char* h, std::size_t limit, char c) noexcept {
+#if defined(PROJECT2_HAS_SSE2)
+    return rfind_byte_sse2(h, limit, c);
+#else
+    return rfind_byte_scalar(h, limit, c);
+#endif
+}
+
+// Last occurrence of s[0, m) starting at or before limit; m >= 1 and
+// limit <= n - m, so every candidate window lies inside the haystack.
+inline std::size_t rfind(const char* h, std::size_t limit, const char* s, std::size_t m) noexcept {
+    if (m == 1) return rfind_byte(h, limit, s[0]);
+    if (m >= horspool_threshold) {
+        horspool_table table;
+        table.build_backward(s, m);
+        return rfind_horspool(h, limit, s, m, table);
+    }
+#if defined(PROJECT2_HAS_AVX2)
+    if (cpu_has_avx2()) return rfind_avx2(h, limit, s, m);
+#endif
+#if defined(PROJECT2_HAS_SSE2)
+    return rfind_sse2(h, limit, s, m);
+#else
+    return rfind_scalar(h, limit, s, m);
+#endif
+}
+
+} // namespace detail
+} // namespace project2
+
+#endif // PROJECT2_DETAIL_STRING_SEARCH_HPP
@@ -0,0 +1,227 @@
+#ifndef PROJECT2_INTERN_POOL_HPP
+#define PROJECT2_INTERN_POOL_HPP
+
+// String interning: each distinct string is stored once and handed out as a
+// string_view into the pool, together with a small integer id.
+//
+// The characters live in large arena blocks that are never moved or freed
+// before the pool itself, so the views stay valid for the pool's lifetime
+// (moving the pool keeps them valid too). Two strings interned in the same
+// pool are equal exactly when their views have the same data() pointer, or
+// their ids are equal, so comparisons need not look at the characters. Every
+// interned string is followed by a NUL, so data() can be passed to C APIs.
+//
+// intern_pool is not thread-safe. sharded_intern_pool splits the strings
+// across independently locked pools by hash, for many threads interning at
+// once.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "string_view.hpp"
+
+namespace project2 {
+
+class intern_pool {
+public:
+    using id_type = std::uint32_t;
+    static constexpr id_type no_id = static_cast<id_type>(-1);
+
+    // Strings longer than a quarter of block_size get a block of their own,
+    // so a long string never wastes the tail of a shared block.
+    explicit intern_pool(std::size_t block_size = 64 * 1024) : block_size_(block_size < 64 ? 64 : block_size) {}
+
+    intern_pool(const intern_pool&) = delete;
+    intern_pool& operator=(const intern_pool&) = delete;
+    // The moved-from pool is left empty and usable: it must not keep
+    // appending to the block that now belongs to the other pool.
+    intern_pool(intern_pool&& other) noexcept
+        : block_size_(other.block_size_),
+          blocks_(std::move(other.blocks_)),
+          cursor_(std::exchange(other.cursor_, nullptr)),
+          left_(std::exchange(other.left_, 0)),
+          reserved_(std::exchange(other.reserved_, 0)),
+          strings_(std::move(other.strings_)),
+          index_(std::move(other.index_)) {
+        other.clear_tables();
+    }
+
+    intern_pool& operator=(intern_pool&& other) noexcept {
+        if (this != &other) {
+            block_size_ = other.block_size_;
+            blocks_ = std::move(other.blocks_);
+            cursor_ = std::exchange(other.cursor_, nullptr);
+            left_ = std::exchange(other.left_, 0);
+            reserved_ = std::exchange(other.reserved_, 0);
+            strings_ = std::move(other.strings_);
+            index_ = std::move(other.index_);
+            other.clear_tables();
+        }
+        return *this;
+    }
+
+    // The pool's copy of s, storing it on first sight.
+    string_view intern(string_view s) { return strings_[id(s)]; }
+
+    // The id of s, storing it on first sight. Ids count up from 0 in the
+    // order strings were first interned.
+    id_type id(string_view s) {
+        const auto it = index_.find(s);
+        if (it != index_.end()) return it->second;
+        const id_type next = static_cast<id_type>(strings_.size());
+        const string_view stored = store(s);
+        strings_.push_back(stored);
+        index_.emplace(stored, next);
+        return next;
+    }
+
+    // The id of s if it was interned, no_id otherwise; never stores.
+    id_type find(string_view s) const {
+        const auto it = index_.find(s);
+        return it == index_.end() ? no_id : it->second;
+    }
+
+    // The string with id i; i must have come from this pool.
+    string_view operator[](id_type i) const noexcept { return strings_[i]; }
+
+    std::size_t size() const noexcept { return strings_.size(); }
+    bool empty() const noexcept { return strings_.empty(); }
+
+    // Arena bytes reserved, including unused block tails.
+    std::size_t capacity_bytes() const noexcept { return reserved_; }
+
+    void reserve(std::size_t count) {
+        index_.reserve(count);
+        strings_.reserve(count);
+    }
+
+private:
+    std::size_t block_size_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* cursor_ = nullptr; // free space in the current shared block
+    std::size_t left_ = 0;
+    std::size_t reserved_ = 0;
+    std::vector<string_view> strings_;               // by id
+    std::unordered_map<string_view, id_type> index_; // keys point into the arena
+
+    // Moved-from containers are only valid but unspecified
+    void clear_tables() noexcept {
+        blocks_.clear();
+        strings_.clear();
+        index_.clear();
+    }
+
+    string_view store(string_view s) {
+        const std::size_t need = s.size() + 1;
+        char* p;
+        if (need > block_size_ / 4) {
+            blocks_.emplace_back(new char[need]);
+            p = blocks_.back().get();
+            reserved_ += need;
+        } else {
+            if (need > left_) {
+                blocks_.emplace_back(new char[block_size_]);
+                cursor_ = blocks_.back().get();
+                left_ = block_size_;
+                reserved_ += block_size_;
+            }
+            p = cursor_;
+            cursor_ += need;
+            left_ -= need;
+        }
+        if (!s.empty()) std::memcpy(p, s.data(), s.size());
+        p[s.size()] = '\0';
+        return string_view(p, s.size());
+    }
+};
+
+// intern_pool for concurrent use. A string's hash picks one of shard_count
+// pools, each behind its own mutex, so threads interning different strings
+// rarely wait for each other. operator[] locks the id's shard only to look
+// the view up; the characters it points at never move, so reading them
+// needs no lock.
+//
+// Ids are unique across the pool but not dense: the low bits name the shard
+// and the rest is the id within it.
+class sharded_intern_pool {
+public:
+    using id_type = intern_pool::id_type;
+    static constexpr id_type no_id = intern_pool::no_id;
+    static constexpr unsigned shard_bits = 4;
+    static constexpr std::size_t shard_count = std::size_t(1) << shard_bits;
+
+    explicit sharded_intern_pool(std::size_t block_size = 64 * 1024) {
+        for (shard& s : shards_) s.pool = intern_pool(block_size);
+    }
+
+    sharded_intern_pool(const sharded_intern_pool&) = delete;
+    sharded_intern_pool& operator=(const sharded_intern_pool&) = delete;
+
+    string_view intern(string_view s) {
+        shard& sh = shard_for(s);
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        return sh.pool.intern(s);
+    }
+
+    id_type id(string_view s) {
+        const std::size_t index = shard_index(s);
+        shard& sh = shards_[index];
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        return combine(sh.pool.id(s), index);
+    }
+
+    id_type find(string_view s) const {
+        const std::size_t index = shard_index(s);
+        const shard& sh = shards_[index];
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        const id_type local = sh.pool.find(s);
+        return local == no_id ? no_id : combine(local, index);
+    }
+
+    string_view operator[](id_type i) const {
+        const shard& sh = shards_[i & (shard_count - 1)];
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        return sh.pool[i >> shard_bits];
+    }
+
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const shard& sh : shards_) {
+            std::lock_guard<std::mutex> lock(sh.mutex);
+            total += sh.pool.size();
+        }
+        return total;
+    }
+
+private:
+    // Each shard on its own cache lines, so locking one does not slow its
+    // neighbours.
+    struct alignas(64) shard {
+        mutable std::mutex mutex;
+        intern_pool pool;
+    };
+
+    shard shards_[shard_count];
+
+    // The top bits of the hash pick the shard; the shard's table hashes the
+    // string again for its own buckets.
+    static std::size_t shard_index(string_view s) noexcept {
+        const std::uint64_t h = detail::hash_bytes(s.data(), s.size());
+        return static_cast<std::size_t>(h >> (64 - shard_bits));
+    }
+
+    shard& shard_for(string_view s) noexcept { return shards_[shard_index(s)]; }
+
+    static id_type combine(id_type local, std::size_t index) noexcept {
+        return static_cast<id_type>(local << shard_bits | index);
+    }
+};
+
+} // namespace project2
+
+#endif // PROJECT2_INTERN_POOL_HPP
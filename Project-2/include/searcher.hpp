@@ -0,0 +1,254 @@
+#ifndef PROJECT2_SEARCHER_HPP
+#define PROJECT2_SEARCHER_HPP
+
+// Needles compiled once for many searches.
+//
+// string_view::find has to look at the needle on every call. A searcher does
+// that work up front: it picks the two rarest needle bytes for the SIMD filter
+// (instead of the first and last, which are often common letters), builds the
+// Horspool tables for long needles and settles the AVX2 / SSE2 choice.
+// multi_searcher does the same for a set of needles and reports which one
+// matched.
+//
+// Both own a copy of their needles, so the strings they were built from need
+// not outlive them.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include "string_view.hpp"
+
+namespace project2 {
+
+class searcher {
+public:
+    using size_type = string_view::size_type;
+    static constexpr size_type npos = string_view::npos;
+
+    explicit searcher(string_view needle) : needle_(needle.data(), needle.size()), avx2_(detail::cpu_has_avx2()) {
+        const size_type m = needle_.size();
+        if (m >= detail::horspool_threshold) {
+            tables_.resize(2);
+            tables_[0].build_forward(needle_.data(), m);
+            tables_[1].build_backward(needle_.data(), m);
+        } else if (m >= 2) {
+            detail::rare_pair(needle_.data(), m, lo_, hi_);
+        }
+    }
+
+    string_view needle() const noexcept { return string_view(needle_); }
+
+    // Same results as haystack.find(needle(), pos).
+    size_type find_in(string_view haystack, size_type pos = 0) const noexcept {
+        const size_type m = needle_.size();
+        if (pos > haystack.size()) return npos;
+        if (m == 0) return pos;
+        if (m > haystack.size() - pos) return npos;
+
+        const char* h = haystack.data() + pos;
+        const size_type n = haystack.size() - pos;
+        const char* s = needle_.data();
+        size_type r;
+        if (m == 1) {
+            const void* p = std::memchr(h, s[0], n);
+            r = p ? static_cast<size_type>(static_cast<const char*>(p) - h) : npos;
+        } else if (!tables_.empty()) {
+            r = detail::find_horspool(h, n, s, m, tables_[0]);
+        } else {
+#if defined(PROJECT2_HAS_AVX2)
+            r = avx2_ ? detail::find_avx2(h, n, s, m, lo_, hi_) : detail::find_sse2(h, n, s, m, lo_, hi_);
+#elif defined(PROJECT2_HAS_SSE2)
+            r = detail::find_sse2(h, n, s, m, lo_, hi_);
+#else
+            r = detail::find_scalar(h, n, s, m);
+#endif
+        }
+        return r == npos ? npos : r + pos;
+    }
+
+    // Same results as haystack.rfind(needle(), pos).
+    size_type rfind_in(string_view haystack, size_type pos = npos) const noexcept {
+        const size_type m = needle_.size();
+        if (m > haystack.size()) return npos;
+        const size_type limit = std::min(pos, haystack.size() - m);
+        if (m == 0) return limit;
+
+        const char* h = haystack.data();
+        const char* s = needle_.data();
+        if (m == 1) return detail::rfind_byte(h, limit, s[0]);
+        if (!tables_.empty()) return detail::rfind_horspool(h, limit, s, m, tables_[1]);
+#if defined(PROJECT2_HAS_AVX2)
+        return avx2_ ? detail::rfind_avx2(h, limit, s, m, lo_, hi_) : detail::rfind_sse2(h, limit, s, m, lo_, hi_);
+#elif defined(PROJECT2_HAS_SSE2)
+        return detail::rfind_sse2(h, limit, s, m, lo_, hi_);
+#else
+        return detail::rfind_scalar(h, limit, s, m);
+#endif
+    }
+
+private:
+    std::string needle_;
+    std::size_t lo_ = 0; // positions of the filter bytes
+    std::size_t hi_ = 0;
+    bool avx2_;
+    std::vector<detail::horspool_table> tables_; // forward and backward, long needles only
+};
+
+class multi_searcher {
+public:
+    using size_type = string_view::size_type;
+    static constexpr size_type npos = string_view::npos;
+
+    // position is npos when nothing matched.
+    struct match {
+        size_type position;
+        size_type needle; // index in construction order
+    };
+
+    multi_searcher(std::initializer_list<string_view> needles) : multi_searcher(needles.begin(), needles.end()) {}
+
+    // From any range of values convertible to string_view.
+    template <typename InputIt>
+    multi_searcher(InputIt first, InputIt last) : avx2_(detail::cpu_has_avx2()) {
+        for (; first != last; ++first) {
+            const string_view needle(*first);
+            offsets_.push_back(storage_.size());
+            storage_.insert(storage_.end(), needle.begin(), needle.end());
+        }
+        offsets_.push_back(storage_.size());
+        build();
+    }
+
+    multi_searcher(const multi_searcher& other)
+        : storage_(other.storage_), offsets_(other.offsets_), avx2_(other.avx2_) {
+        build();
+    }
+
+    multi_searcher& operator=(const multi_searcher& other) {
+        if (this != &other) {
+            storage_ = other.storage_;
+            offsets_ = other.offsets_;
+            avx2_ = other.avx2_;
+            build();
+        }
+        return *this;
+    }
+
+    // Moving a vector keeps its buffer, so the needle pointers stay valid.
+    multi_searcher(multi_searcher&&) noexcept = default;
+    multi_searcher& operator=(multi_searcher&&) noexcept = default;
+
+    size_type size() const noexcept { return offsets_.size() - 1; }
+
+    string_view needle(size_type i) const noexcept {
+        return string_view(storage_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+
+    // Leftmost match at or after pos. Of needles that match at the same
+    // position, the one listed first is reported.
+    match find_in(string_view haystack, size_type pos = 0) const noexcept {
+        if (pos > haystack.size() || size() == 0) return {npos, 0};
+        if (empty_needle_ != npos) {
+            // The empty needle matches at pos itself; a needle listed before
+            // it can only tie there.
+            const string_view rest = haystack.substr(pos);
+            for (size_type i = 0; i < empty_needle_; ++i) {
+                if (rest.starts_with(needle(i))) return {pos, i};
+            }
+            return {pos, empty_needle_};
+        }
+
+        const char* h = haystack.data() + pos;
+        const size_type n = haystack.size() - pos;
+        size_type which = 0;
+        size_type r;
+        if (filtered_.size() <= detail::multi_filter_limit) {
+#if defined(PROJECT2_HAS_AVX2)
+            r = avx2_ ? detail::find_any_avx2(h, n, filtered_.data(), filtered_.size(), max_length_, which)
+                      : detail::find_any_sse2(h, n, filtered_.data(), filtered_.size(), max_length_, which);
+#elif defined(PROJECT2_HAS_SSE2)
+            r = detail::find_any_sse2(h, n, filtered_.data(), filtered_.size(), max_length_, which);
+#else
+            r = detail::find_any_scalar(h, n, filtered_.data(), filtered_.size(), which);
+#endif
+        } else {
+            r = find_bucketed(h, n, which);
+        }
+        return r == npos ? match{npos, 0} : match{r + pos, which};
+    }
+
+private:
+    std::vector<char> storage_;      // all needles back to back
+    std::vector<size_type> offsets_; // size() + 1 entries into storage_
+    bool avx2_;
+
+    // derived from the above by build()
+    std::vector<detail::filtered_needle> filtered_; // points into storage_
+    size_type max_length_ = 0;
+    size_type empty_needle_ = npos;
+    // Needle indices grouped by first byte, for sets too large to filter.
+    size_type bucket_begin_[257] = {};
+    std::vector<size_type> buckets_;
+
+    void build() {
+        filtered_.clear();
+        buckets_.clear();
+        max_length_ = 0;
+        empty_needle_ = npos;
+        for (size_type i = 0; i < size(); ++i) {
+            const string_view s = needle(i);
+            if (s.empty()) {
+                if (empty_needle_ == npos) empty_needle_ = i;
+                continue;
+            }
+            detail::filtered_needle f{s.data(), s.size(), 0, 0};
+            if (s.size() >= 2) detail::rare_pair(s.data(), s.size(), f.lo, f.hi);
+            filtered_.push_back(f);
+            max_length_ = std::max(max_length_, s.size());
+        }
+
+        size_type counts[256] = {};
+        for (const auto& f : filtered_) ++counts[static_cast<unsigned char>(f.s[0])];
+        bucket_begin_[0] = 0;
+        for (size_type c = 0; c < 256; ++c) bucket_begin_[c + 1] = bucket_begin_[c] + counts[c];
+        buckets_.resize(filtered_.size());
+        size_type fill[256];
+        std::copy(bucket_begin_, bucket_begin_ + 256, fill);
+        for (size_type k = 0; k < filtered_.size(); ++k) {
+            buckets_[fill[static_cast<unsigned char>(filtered_[k].s[0])]++] = k;
+        }
+    }
+
+    size_type find_bucketed(const char* h, size_type n, size_type& which) const noexcept {
+        for (size_type i = 0; i < n; ++i) {
+            const unsigned char c = static_cast<unsigned char>(h[i]);
+            for (size_type b = bucket_begin_[c]; b < bucket_begin_[c + 1]; ++b) {
+                const detail::filtered_needle& f = filtered_[buckets_[b]];
+                if (f.m <= n - i && std::memcmp(h + i, f.s, f.m) == 0) {
+                    which = buckets_[b];
+                    return i;
+                }
+            }
+        }
+        return npos;
+    }
+};
+
+inline string_view::size_type string_view::find(const searcher& s, size_type pos) const noexcept {
+    return s.find_in(*this, pos);
+}
+
+inline string_view::size_type string_view::rfind(const searcher& s, size_type pos) const noexcept {
+    return s.rfind_in(*this, pos);
+}
+
+inline string_view::size_type string_view::find(const multi_searcher& s, size_type pos) const noexcept {
+    return s.find_in(*this, pos).position;
+}
+
+} // namespace project2
+
+#endif // PROJECT2_SEARCHER_HPP
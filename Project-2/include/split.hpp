@@ -0,0 +1,148 @@
+#ifndef PROJECT2_SPLIT_HPP
+#define PROJECT2_SPLIT_HPP
+
+// Lazy splitting of a string_view into tokens.
+//
+//     for (project2::string_view line : project2::split(text, '\n')) { ... }
+//
+// split() returns a range whose forward iterators find the next delimiter
+// only when advanced, and every token is a string_view into the original
+// text, so nothing is allocated or copied. The delimiter is a single char, a
+// string, or a char_set (any one of its characters).
+//
+// Splitting follows std::views::split: adjacent delimiters give an empty
+// token between them, a trailing delimiter gives a trailing empty token, and
+// an empty text gives no tokens at all. An empty string delimiter splits
+// between every character.
+//
+// The range refers to the text without owning it, and iterators refer to the
+// range, so both must outlive the loop.
+
+#include <cstddef>
+#include <iterator>
+#include "char_set.hpp"
+#include "string_view.hpp"
+
+namespace project2 {
+
+namespace detail {
+
+// Each delimiter finds its next occurrence at or after from, returning npos
+// if there is none, and reports how many characters it spans.
+struct char_delimiter {
+    char c;
+
+    std::size_t find(string_view text, std::size_t from) const noexcept { return text.find(c, from); }
+    std::size_t length() const noexcept { return 1; }
+};
+
+struct string_delimiter {
+    string_view s;
+
+    std::size_t find(string_view text, std::size_t from) const noexcept {
+        if (s.empty()) return from + 1 < text.size() ? from + 1 : string_view::npos;
+        return text.find(s, from);
+    }
+    std::size_t length() const noexcept { return s.size(); }
+};
+
+struct set_delimiter {
+    char_set set;
+
+    std::size_t find(string_view text, std::size_t from) const noexcept { return text.find_first_of(set, from); }
+    std::size_t length() const noexcept { return 1; }
+};
+
+} // namespace detail
+
+template <typename Delimiter>
+class split_view {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const string_view*;
+        using reference = const string_view&;
+
+        iterator() noexcept = default;
+
+        reference operator*() const noexcept { return token_; }
+        pointer operator->() const noexcept { return &token_; }
+
+        iterator& operator++() noexcept {
+            if (next_ == string_view::npos) {
+                begin_ = string_view::npos; // that was the last token
+            } else {
+                advance_to(next_);
+            }
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.begin_ == b.begin_; }
+        friend bool operator!=(const iterator& a, const iterator& b) noexcept { return !(a == b); }
+
+    private:
+        friend class split_view;
+
+        const split_view* view_ = nullptr;
+        std::size_t begin_ = string_view::npos; // npos once past the last token
+        std::size_t next_ = string_view::npos;  // start of the token after this one
+        string_view token_;
+
+        iterator(const split_view* view, std::size_t begin) noexcept : view_(view) { advance_to(begin); }
+
+        void advance_to(std::size_t begin) noexcept {
+            const string_view text = view_->text_;
+            begin_ = begin;
+            const std::size_t found = view_->delimiter_.find(text, begin);
+            if (found == string_view::npos) {
+                token_ = string_view(text.data() + begin, text.size() - begin);
+                next_ = string_view::npos;
+            } else {
+                token_ = string_view(text.data() + begin, found - begin);
+                next_ = found + view_->delimiter_.length();
+            }
+        }
+    };
+
+    using const_iterator = iterator;
+
+    split_view(string_view text, Delimiter delimiter) noexcept : text_(text), delimiter_(delimiter) {}
+
+    iterator begin() const noexcept { return text_.empty() ? iterator() : iterator(this, 0); }
+    iterator end() const noexcept { return iterator(); }
+
+    string_view text() const noexcept { return text_; }
+
+private:
+    string_view text_;
+    Delimiter delimiter_;
+};
+
+inline split_view<detail::char_delimiter> split(string_view text, char delimiter) noexcept {
+    return split_view<detail::char_delimiter>(text, detail::char_delimiter{delimiter});
+}
+
+inline split_view<detail::string_delimiter> split(string_view text, string_view delimiter) noexcept {
+    return split_view<detail::string_delimiter>(text, detail::string_delimiter{delimiter});
+}
+
+inline split_view<detail::string_delimiter> split(string_view text, const char* delimiter) noexcept {
+    return split(text, string_view(delimiter));
+}
+
+inline split_view<detail::set_delimiter> split(string_view text, const char_set& delimiters) noexcept {
+    return split_view<detail::set_delimiter>(text, detail::set_delimiter{delimiters});
+}
+
+} // namespace project2
+
+#endif // PROJECT2_SPLIT_HPP
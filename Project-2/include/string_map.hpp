@@ -0,0 +1,150 @@
+#ifndef PROJECT2_STRING_MAP_HPP
+#define PROJECT2_STRING_MAP_HPP
+
+// Hash maps with string keys that can be queried with a string_view.
+//
+// string_hash and string_equal are transparent: they hash and compare
+// std::string, const char* and string_view alike, so with C++20's
+// heterogeneous lookup
+//
+//     std::unordered_map<std::string, V, string_hash, string_equal> m;
+//     m.find(project2::string_view("key"));   // no std::string built
+//
+// works directly. C++17 unordered_map::find only takes the key type, which
+// is why string_map exists: its keys are string_key, which either owns a copy
+// of the characters (every key stored in the map) or just points at them
+// (the temporary key a lookup builds), so find, count and erase never
+// allocate. Keys are copied once, on insertion.
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "string_view.hpp"
+
+namespace project2 {
+
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(string_view sv) const noexcept { return std::hash<string_view>()(sv); }
+    std::size_t operator()(const std::string& s) const noexcept { return (*this)(string_view(s)); }
+    std::size_t operator()(const char* s) const noexcept { return (*this)(string_view(s)); }
+};
+
+struct string_equal {
+    using is_transparent = void;
+
+    bool operator()(string_view a, string_view b) const noexcept { return a == b; }
+};
+
+// A map key: either an owned copy of some characters or a view of them.
+class string_key {
+public:
+    // Borrows: the characters must outlive the key.
+    explicit string_key(string_view sv) noexcept : data_(sv.data()), size_(sv.size()) {}
+
+    static string_key copy_of(string_view sv) {
+        string_key key(sv);
+        if (sv.size() != 0) {
+            key.storage_.reset(new char[sv.size()]);
+            std::memcpy(key.storage_.get(), sv.data(), sv.size());
+            key.data_ = key.storage_.get();
+        }
+        return key;
+    }
+
+    // Copies own their characters whenever the original did.
+    string_key(const string_key& other) : data_(other.data_), size_(other.size_) {
+        if (other.storage_) {
+            storage_.reset(new char[size_]);
+            std::memcpy(storage_.get(), other.data_, size_);
+            data_ = storage_.get();
+        }
+    }
+    string_key(string_key&&) noexcept = default;
+    string_key& operator=(const string_key& other) {
+        if (this != &other) *this = string_key(other);
+        return *this;
+    }
+    string_key& operator=(string_key&&) noexcept = default;
+
+    string_view view() const noexcept { return string_view(data_, size_); }
+    operator string_view() const noexcept { return view(); }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::unique_ptr<char[]> storage_;
+};
+
+template <typename V>
+class string_map {
+    using map_type = std::unordered_map<string_key, V, string_hash, string_equal>;
+
+public:
+    using key_type = string_key;
+    using mapped_type = V;
+    using value_type = typename map_type::value_type;
+    using size_type = typename map_type::size_type;
+    using iterator = typename map_type::iterator;
+    using const_iterator = typename map_type::const_iterator;
+
+    iterator begin() noexcept { return map_.begin(); }
+    iterator end() noexcept { return map_.end(); }
+    const_iterator begin() const noexcept { return map_.begin(); }
+    const_iterator end() const noexcept { return map_.end(); }
+
+    size_type size() const noexcept { return map_.size(); }
+    bool empty() const noexcept { return map_.empty(); }
+    void clear() noexcept { map_.clear(); }
+    void reserve(size_type count) { map_.reserve(count); }
+
+    iterator find(string_view key) { return map_.find(string_key(key)); }
+    const_iterator find(string_view key) const { return map_.find(string_key(key)); }
+    size_type count(string_view key) const { return map_.count(string_key(key)); }
+    bool contains(string_view key) const { return find(key) != end(); }
+
+    V& at(string_view key) {
+        iterator it = find(key);
+        if (it == end()) throw std::out_of_range("project2::string_map::at: key not found");
+        return it->second;
+    }
+
+    const V& at(string_view key) const {
+        const_iterator it = find(key);
+        if (it == end()) throw std::out_of_range("project2::string_map::at: key not found");
+        return it->second;
+    }
+
+    // Copies the key only if it is not already present.
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(string_view key, Args&&... args) {
+        iterator it = find(key);
+        if (it != end()) return {it, false};
+        return map_.try_emplace(string_key::copy_of(key), std::forward<Args>(args)...);
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(string_view key, M&& value) {
+        std::pair<iterator, bool> r = try_emplace(key, std::forward<M>(value));
+        if (!r.second) r.first->second = std::forward<M>(value);
+        return r;
+    }
+
+    V& operator[](string_view key) { return try_emplace(key).first->second; }
+
+    size_type erase(string_view key) { return map_.erase(string_key(key)); }
+    iterator erase(const_iterator pos) { return map_.erase(pos); }
+
+private:
+    map_type map_;
+};
+
+} // namespace project2
+
+#endif // PROJECT2_STRING_MAP_HPP
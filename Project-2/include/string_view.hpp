@@ -3,17 +3,30 @@
 
 // Minimal C++17-compatible implementation of a string_view-like class for educational use.
 // Placed into namespace project2 to avoid colliding with the standard library's std::string_view.
+//
+// Everything except the std::string constructor, to_string and stream output
+// is constexpr. Comparisons go through std::char_traits, which is constexpr
+// and still calls memcmp / memchr at run time; the vectorized searches check
+// detail::is_constant_evaluated() and run a plain loop at compile time.
 
 #include <cstddef>
 #include <cstring>
+#include <functional>
 #include <string>
 #include <stdexcept>
 #include <algorithm>
 #include <iterator>
 #include <ostream>
+#include "char_set.hpp"
+#include "detail/char_class.hpp"
+#include "detail/hash.hpp"
+#include "detail/string_search.hpp"
 
 namespace project2 {
 
+class searcher;
+class multi_searcher;
+
 class string_view {
 public:
     using value_type = char;
@@ -25,11 +38,12 @@ public:
     using iterator = const_iterator;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
+    using traits_type = std::char_traits<char>;
 
     // constructors
     constexpr string_view() noexcept : data_(nullptr), size_(0) {}
-    constexpr string_view(const char* s, size_type count) : data_(s), size_(count) {}
-    constexpr string_view(const char* s) : data_(s), size_(s ? std::strlen(s) : 0) {}
+    constexpr string_view(const char* s, size_type count) noexcept : data_(s), size_(count) {}
+    constexpr string_view(const char* s) noexcept : data_(s), size_(s ? traits_type::length(s) : 0) {}
     string_view(const std::string& s) noexcept : data_(s.data()), size_(s.size()) {}
 
     // observers
@@ -57,9 +71,10 @@ public:
         else size_ -= n;
     }
 
-    void swap(string_view& other) noexcept {
-        std::swap(data_, other.data_);
-        std::swap(size_, other.size_);
+    constexpr void swap(string_view& other) noexcept {
+        const string_view tmp = *this;
+        *this = other;
+        other = tmp;
     }
 
     // iterators
@@ -70,6 +85,7 @@ public:
 
     // conversion
     std::string to_string() const { return std::string(data_, size_); }
+    explicit operator std::string() const { return to_string(); }
 
     // substr
     constexpr string_view substr(size_type pos = 0, size_type count = npos) const {
@@ -79,87 +95,170 @@ public:
     }
 
     // compare: mimic std::string_view::compare behavior
-    int compare(string_view other) const noexcept {
+    constexpr int compare(string_view other) const noexcept {
         const size_type r = std::min(size_, other.size_);
-        int cmp = std::memcmp(data_, other.data_, r);
+        int cmp = traits_type::compare(data_, other.data_, r);
         if (cmp != 0) return cmp;
         if (size_ < other.size_) return -1;
         if (size_ > other.size_) return 1;
         return 0;
     }
 
-    // find (naive implementations)
+    // find / rfind; the substring searches are vectorized, see
+    // detail/string_search.hpp
     static constexpr size_type npos = static_cast<size_type>(-1);
 
-    size_type find(char c, size_type pos = 0) const noexcept {
+    constexpr size_type find(char c, size_type pos = 0) const noexcept {
         if (pos >= size_) return npos;
-        const char* p = static_cast<const char*>(std::memchr(data_ + pos, c, size_ - pos));
+        const char* p = traits_type::find(data_ + pos, size_ - pos, c);
         if (!p) return npos;
         return static_cast<size_type>(p - data_);
     }
 
-    size_type find(const char* s, size_type pos, size_type count) const noexcept {
+    constexpr size_type find(const char* s, size_type pos, size_type count) const noexcept {
         if (!s) return npos;
         if (count == 0) return (pos <= size_) ? pos : npos;
         if (pos > size_ || count > size_ - pos) return npos;
-        // naive search
-        for (size_type i = pos; i + count <= size_; ++i) {
-            if (std::memcmp(data_ + i, s, count) == 0) return i;
-        }
-        return npos;
+        size_type r = detail::is_constant_evaluated() ? detail::find_constant(data_ + pos, size_ - pos, s, count)
+                                                      : detail::find(data_ + pos, size_ - pos, s, count);
+        return r == npos ? npos : r + pos;
     }
 
-    size_type find(string_view sv, size_type pos = 0) const noexcept {
+    constexpr size_type find(string_view sv, size_type pos = 0) const noexcept {
         return find(sv.data_, pos, sv.size_);
     }
 
-    size_type find(const char* s, size_type pos = 0) const noexcept {
+    constexpr size_type find(const char* s, size_type pos = 0) const noexcept {
         if (!s) return npos;
-        return find(s, pos, std::strlen(s));
+        return find(s, pos, traits_type::length(s));
     }
 
-    size_type rfind(char c, size_type pos = npos) const noexcept {
+    constexpr size_type rfind(char c, size_type pos = npos) const noexcept {
         if (size_ == 0) return npos;
-        size_type i = (pos >= size_) ? size_ - 1 : pos;
-        for (;; --i) {
-            if (data_[i] == c) return i;
-            if (i == 0) break;
-        }
-        return npos;
+        const size_type limit = (pos >= size_) ? size_ - 1 : pos;
+        return detail::is_constant_evaluated() ? detail::rfind_byte_scalar(data_, limit, c)
+                                               : detail::rfind_byte(data_, limit, c);
     }
 
-    size_type rfind(string_view sv, size_type pos = npos) const noexcept {
+    constexpr size_type rfind(string_view sv, size_type pos = npos) const noexcept {
         if (sv.size_ > size_) return npos;
         size_type limit = (pos >= size_) ? size_ - sv.size_ : std::min(pos, size_ - sv.size_);
-        for (size_type i = limit + 1; i > 0; --i) {
-            size_type j = i - 1;
-            if (std::memcmp(data_ + j, sv.data_, sv.size_) == 0) return j;
-        }
-        return npos;
+        if (sv.size_ == 0) return limit;
+        return detail::is_constant_evaluated() ? detail::rfind_constant(data_, limit, sv.data_, sv.size_)
+                                               : detail::rfind(data_, limit, sv.data_, sv.size_);
+    }
+
+    // with a precompiled needle; defined in searcher.hpp
+    size_type find(const searcher& s, size_type pos = 0) const noexcept;
+    size_type rfind(const searcher& s, size_type pos = npos) const noexcept;
+    size_type find(const multi_searcher& s, size_type pos = 0) const noexcept;
+
+    // find_first_of / find_last_of and the *_not_of variants. The character
+    // set is classified 16 or 32 bytes at a time, see detail/char_class.hpp;
+    // a char_set built once saves rebuilding it on every call.
+    constexpr size_type find_first_of(const char_set& set, size_type pos = 0) const noexcept { return first_in(set, pos, false); }
+    constexpr size_type find_first_of(string_view sv, size_type pos = 0) const noexcept {
+        if (sv.size_ == 1) return find(sv.data_[0], pos);
+        return first_in(char_set(sv.data_, sv.size_), pos, false);
+    }
+    constexpr size_type find_first_of(char c, size_type pos = 0) const noexcept { return find(c, pos); }
+    constexpr size_type find_first_of(const char* s, size_type pos, size_type count) const noexcept {
+        if (!s) return npos;
+        return find_first_of(string_view(s, count), pos);
+    }
+    constexpr size_type find_first_of(const char* s, size_type pos = 0) const noexcept {
+        if (!s) return npos;
+        return find_first_of(string_view(s), pos);
+    }
+
+    constexpr size_type find_last_of(const char_set& set, size_type pos = npos) const noexcept { return last_in(set, pos, false); }
+    constexpr size_type find_last_of(string_view sv, size_type pos = npos) const noexcept {
+        if (sv.size_ == 1) return rfind(sv.data_[0], pos);
+        return last_in(char_set(sv.data_, sv.size_), pos, false);
+    }
+    constexpr size_type find_last_of(char c, size_type pos = npos) const noexcept { return rfind(c, pos); }
+    constexpr size_type find_last_of(const char* s, size_type pos, size_type count) const noexcept {
+        if (!s) return npos;
+        return find_last_of(string_view(s, count), pos);
+    }
+    constexpr size_type find_last_of(const char* s, size_type pos = npos) const noexcept {
+        if (!s) return npos;
+        return find_last_of(string_view(s), pos);
+    }
+
+    constexpr size_type find_first_not_of(const char_set& set, size_type pos = 0) const noexcept { return first_in(set, pos, true); }
+    constexpr size_type find_first_not_of(string_view sv, size_type pos = 0) const noexcept {
+        return first_in(char_set(sv.data_, sv.size_), pos, true);
+    }
+    constexpr size_type find_first_not_of(char c, size_type pos = 0) const noexcept {
+        return first_in(char_set(&c, 1), pos, true);
+    }
+    constexpr size_type find_first_not_of(const char* s, size_type pos, size_type count) const noexcept {
+        if (!s) return npos;
+        return find_first_not_of(string_view(s, count), pos);
+    }
+    constexpr size_type find_first_not_of(const char* s, size_type pos = 0) const noexcept {
+        if (!s) return npos;
+        return find_first_not_of(string_view(s), pos);
+    }
+
+    constexpr size_type find_last_not_of(const char_set& set, size_type pos = npos) const noexcept { return last_in(set, pos, true); }
+    constexpr size_type find_last_not_of(string_view sv, size_type pos = npos) const noexcept {
+        return last_in(char_set(sv.data_, sv.size_), pos, true);
+    }
+    constexpr size_type find_last_not_of(char c, size_type pos = npos) const noexcept {
+        return last_in(char_set(&c, 1), pos, true);
+    }
+    constexpr size_type find_last_not_of(const char* s, size_type pos, size_type count) const noexcept {
+        if (!s) return npos;
+        return find_last_not_of(string_view(s, count), pos);
+    }
+    constexpr size_type find_last_not_of(const char* s, size_type pos = npos) const noexcept {
+        if (!s) return npos;
+        return find_last_not_of(string_view(s), pos);
     }
 
     // starts_with / ends_with helpers
-    bool starts_with(string_view sv) const noexcept {
+    constexpr bool starts_with(string_view sv) const noexcept {
         if (sv.size_ > size_) return false;
-        return std::memcmp(data_, sv.data_, sv.size_) == 0;
+        return traits_type::compare(data_, sv.data_, sv.size_) == 0;
     }
-    bool ends_with(string_view sv) const noexcept {
+    constexpr bool ends_with(string_view sv) const noexcept {
         if (sv.size_ > size_) return false;
-        return std::memcmp(data_ + (size_ - sv.size_), sv.data_, sv.size_) == 0;
+        return traits_type::compare(data_ + (size_ - sv.size_), sv.data_, sv.size_) == 0;
     }
 
 private:
     const char* data_;
     size_type size_;
+
+    constexpr size_type first_in(const char_set& set, size_type pos, bool negate) const noexcept {
+        if (pos >= size_) return npos;
+        size_type r = detail::is_constant_evaluated() ? detail::find_in_set_scalar(data_ + pos, size_ - pos, set, negate)
+                                                      : detail::find_in_set(data_ + pos, size_ - pos, set, negate);
+        return r == npos ? npos : r + pos;
+    }
+
+    constexpr size_type last_in(const char_set& set, size_type pos, bool negate) const noexcept {
+        if (size_ == 0) return npos;
+        const size_type limit = (pos >= size_) ? size_ - 1 : pos;
+        return detail::is_constant_evaluated() ? detail::rfind_in_set_scalar(data_, limit, set, negate)
+                                               : detail::rfind_in_set(data_, limit, set, negate);
+    }
 };
 
 // relational operators
-inline bool operator==(const string_view& a, const string_view& b) noexcept { return a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size()) == 0); }
-inline bool operator!=(const string_view& a, const string_view& b) noexcept { return !(a == b); }
-inline bool operator<(const string_view& a, const string_view& b) noexcept { return a.compare(b) < 0; }
-inline bool operator<=(const string_view& a, const string_view& b) noexcept { return a.compare(b) <= 0; }
-inline bool operator>(const string_view& a, const string_view& b) noexcept { return a.compare(b) > 0; }
-inline bool operator>=(const string_view& a, const string_view& b) noexcept { return a.compare(b) >= 0; }
+constexpr bool operator==(const string_view& a, const string_view& b) noexcept { return a.size() == b.size() && string_view::traits_type::compare(a.data(), b.data(), a.size()) == 0; }
+constexpr bool operator!=(const string_view& a, const string_view& b) noexcept { return !(a == b); }
+constexpr bool operator<(const string_view& a, const string_view& b) noexcept { return a.compare(b) < 0; }
+constexpr bool operator<=(const string_view& a, const string_view& b) noexcept { return a.compare(b) <= 0; }
+constexpr bool operator>(const string_view& a, const string_view& b) noexcept { return a.compare(b) > 0; }
+constexpr bool operator>=(const string_view& a, const string_view& b) noexcept { return a.compare(b) >= 0; }
+
+// "text"_sv, a string_view of the whole literal including any embedded NULs.
+inline namespace literals {
+constexpr string_view operator""_sv(const char* s, std::size_t count) noexcept { return string_view(s, count); }
+} // namespace literals
 
 // stream insertion helper
 inline std::ostream& operator<<(std::ostream& os, const string_view& sv) {
@@ -169,4 +268,15 @@ inline std::ostream& operator<<(std::ostream& os, const string_view& sv) {
 
 } // namespace project2
 
+// Hashes the characters, so equal views hash alike wherever they point; see
+// detail/hash.hpp.
+namespace std {
+template <>
+struct hash<project2::string_view> {
+    constexpr size_t operator()(project2::string_view sv) const noexcept {
+        return static_cast<size_t>(project2::detail::hash_bytes(sv.data(), sv.size()));
+    }
+};
+} // namespace std
+
 #endif // PROJECT2_STRING_VIEW_HPP
@@ -48,5 +48,18 @@ int main() {
     for (char c : sv1) std::cout << ' ' << c;
     std::cout << '\n';
 
+    // compile-time evaluation
+    using namespace project2::literals;
+    constexpr project2::string_view keyword = "reinterpret_cast"_sv;
+    static_assert(keyword.starts_with("reinterpret"), "compare is constexpr");
+#ifdef PROJECT2_HAS_CONSTANT_EVALUATED
+    static_assert(keyword.find("_cast") == 11, "find is constexpr");
+#endif
+    constexpr std::size_t keyword_hash = std::hash<project2::string_view>()(keyword);
+    const std::string runtime_keyword = keyword.to_string();
+    std::cout << "constexpr find \"_cast\": " << keyword.find("_cast") << "\n"
+              << "constexpr hash matches run time: "
+              << (keyword_hash == std::hash<project2::string_view>()(runtime_keyword)) << "\n";
+
     return 0;
 }
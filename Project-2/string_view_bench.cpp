@@ -0,0 +1,328 @@
+// Benchmark suite: project2::string_view against std::string_view.
+//
+// Usage: string_view_bench [--format=table|csv|json] [--filter=TEXT] [--min-time=SECONDS]
+//
+// Every case runs the same operation through both types: construction,
+// find / rfind over a range of needle and haystack sizes, find_first_of,
+// compare, substr, iteration and hashing. Each measurement repeats the
+// operation until it has run for at least --min-time (0.05 s by default),
+// takes the best of three such runs and reports nanoseconds per operation
+// and, where the operation scans bytes, throughput. Both types must return
+// the same results (hash values aside) or the benchmark fails.
+//
+// --format=csv and --format=json print one record per case and type, for
+// tracking results over time; --filter runs only cases whose name contains
+// TEXT.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "include/string_view.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps a result alive without the compiler being able to see through it.
+template <typename T>
+void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+#endif
+}
+
+struct measurement {
+    double ns_per_op = 0;
+    std::size_t iterations = 0;
+};
+
+// op(i) performs one operation and returns something derived from its
+// result; i varies so that nothing can be hoisted out of the loop.
+template <typename Op>
+measurement measure(double min_seconds, Op&& op) {
+    measurement best;
+    std::size_t iterations = 1;
+    for (;;) {
+        const Clock::time_point start = Clock::now();
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < iterations; ++i) sum += static_cast<std::uint64_t>(op(i));
+        keep(sum);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= min_seconds) break;
+        iterations = seconds <= 0 ? iterations * 16
+                                  : static_cast<std::size_t>(double(iterations) * 1.2 * min_seconds / seconds) + 1;
+    }
+    best.iterations = iterations;
+    best.ns_per_op = -1;
+    for (int run = 0; run < 3; ++run) {
+        const Clock::time_point start = Clock::now();
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < iterations; ++i) sum += static_cast<std::uint64_t>(op(i));
+        keep(sum);
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / double(iterations);
+        if (best.ns_per_op < 0 || ns < best.ns_per_op) best.ns_per_op = ns;
+    }
+    return best;
+}
+
+struct result {
+    std::string name;
+    std::size_t bytes; // bytes scanned per operation, 0 if not meaningful
+    measurement std_sv;
+    measurement p2_sv;
+};
+
+enum class output_format { table, csv, json };
+
+class suite {
+public:
+    suite(double min_seconds, std::string filter) : min_seconds_(min_seconds), filter_(std::move(filter)) {}
+
+    // Runs std_op and p2_op, each taking (iteration) like measure().
+    template <typename StdOp, typename P2Op>
+    void run(const std::string& name, std::size_t bytes, StdOp&& std_op, P2Op&& p2_op) {
+        if (!filter_.empty() && name.find(filter_) == std::string::npos) return;
+        for (std::size_t i = 0; i < 4; ++i) {
+            if (static_cast<std::uint64_t>(std_op(i)) != static_cast<std::uint64_t>(p2_op(i))) {
+                std::cerr << name << ": results differ between std::string_view and project2::string_view\n";
+                failed_ = true;
+                return;
+            }
+        }
+        results_.push_back(result{name, bytes, measure(min_seconds_, std_op), measure(min_seconds_, p2_op)});
+        std::cerr << '.' << std::flush;
+    }
+
+    bool failed() const { return failed_; }
+
+    void print(std::ostream& os, output_format format) const {
+        std::cerr << '\n';
+        switch (format) {
+        case output_format::table:
+            print_table(os);
+            break;
+        case output_format::csv:
+            os << "benchmark,implementation,ns_per_op,bytes_per_second,iterations\n";
+            for (const result& r : results_) {
+                csv_row(os, r, "std", r.std_sv);
+                csv_row(os, r, "project2", r.p2_sv);
+            }
+            break;
+        case output_format::json:
+            os << "{\"benchmarks\":[";
+            for (std::size_t i = 0; i < results_.size(); ++i) {
+                json_record(os, results_[i], "std", results_[i].std_sv, i == 0);
+                json_record(os, results_[i], "project2", results_[i].p2_sv, false);
+            }
+            os << "\n]}\n";
+            break;
+        }
+    }
+
+private:
+    double min_seconds_;
+    std::string filter_;
+    std::vector<result> results_;
+    bool failed_ = false;
+
+    static double bytes_per_second(const result& r, const measurement& m) {
+        return r.bytes == 0 || m.ns_per_op <= 0 ? 0 : double(r.bytes) / m.ns_per_op * 1e9;
+    }
+
+    void print_table(std::ostream& os) const {
+        os << std::left << std::setw(44) << "benchmark" << std::right << std::setw(12) << "std ns" << std::setw(12)
+           << "project2 ns" << std::setw(10) << "speedup" << std::setw(12) << "std GB/s" << std::setw(14)
+           << "project2 GB/s" << '\n';
+        for (const result& r : results_) {
+            os << std::left << std::setw(44) << r.name << std::right << std::fixed << std::setprecision(2)
+               << std::setw(12) << r.std_sv.ns_per_op << std::setw(12) << r.p2_sv.ns_per_op << std::setw(9)
+               << r.std_sv.ns_per_op / r.p2_sv.ns_per_op << 'x';
+            if (r.bytes != 0) {
+                os << std::setw(12) << bytes_per_second(r, r.std_sv) / 1e9 << std::setw(14)
+                   << bytes_per_second(r, r.p2_sv) / 1e9;
+            }
+            os << '\n';
+        }
+    }
+
+    static void csv_row(std::ostream& os, const result& r, const char* impl, const measurement& m) {
+        os << r.name << ',' << impl << ',' << std::setprecision(6) << m.ns_per_op << ',' << std::setprecision(9)
+           << bytes_per_second(r, m) << ',' << m.iterations << '\n';
+    }
+
+    static void json_record(std::ostream& os, const result& r, const char* impl, const measurement& m, bool first) {
+        os << (first ? "\n" : ",\n") << "{\"name\":\"" << r.name << "\",\"implementation\":\"" << impl
+           << "\",\"ns_per_op\":" << std::setprecision(6) << m.ns_per_op << ",\"bytes_per_second\":"
+           << std::setprecision(9) << bytes_per_second(r, m) << ",\"iterations\":" << m.iterations << '}';
+    }
+};
+
+int sign(int x) { return (x > 0) - (x < 0); }
+
+// Lowercase text; '#' never occurs in it, so a needle ending in '#' is only
+// found where it was planted.
+std::string make_text(std::size_t size, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::string text(size, ' ');
+    for (char& c : text) c = static_cast<char>('a' + rng() % 26);
+    return text;
+}
+
+void bench_construct(suite& s) {
+    for (std::size_t length : {8, 64, 1024}) {
+        std::vector<std::string> texts;
+        for (std::uint32_t k = 0; k < 8; ++k) texts.push_back(make_text(length, k));
+        const std::string name = "construct_cstr/length=" + std::to_string(length);
+        s.run(name, length,
+              [&](std::size_t i) { return std::string_view(texts[i & 7].c_str()).size(); },
+              [&](std::size_t i) { return project2::string_view(texts[i & 7].c_str()).size(); });
+    }
+}
+
+void bench_find(suite& s) {
+    for (std::size_t haystack_size : {256, 4096, 1 << 20}) {
+        std::string haystack = make_text(haystack_size, 1);
+        const std::string_view std_hay(haystack);
+        const project2::string_view p2_hay(haystack);
+
+        // A byte that does not occur: the whole haystack is scanned.
+        s.run("find_char/haystack=" + std::to_string(haystack_size), haystack_size,
+              [&](std::size_t i) { return std_hay.find('#', i & 1); },
+              [&](std::size_t i) { return p2_hay.find('#', i & 1); });
+        s.run("rfind_char/haystack=" + std::to_string(haystack_size), haystack_size,
+              [&](std::size_t i) { return std_hay.rfind('#', haystack_size - 1 - (i & 1)); },
+              [&](std::size_t i) { return p2_hay.rfind('#', haystack_size - 1 - (i & 1)); });
+
+        for (std::size_t needle_size : {2, 8, 32, 256}) {
+            if (needle_size * 4 > haystack_size) continue;
+            // Found once, at the far end from where the search starts.
+            const std::string needle = make_text(needle_size - 1, 7) + '#';
+            std::string forward = haystack;
+            forward.replace(haystack_size - needle_size, needle_size, needle);
+            std::string backward = haystack;
+            backward.replace(0, needle_size, needle);
+            const std::string params = "/needle=" + std::to_string(needle_size) + "/haystack=" + std::to_string(haystack_size);
+            const std::string_view std_needle(needle);
+            const project2::string_view p2_needle(needle);
+            const std::string_view std_fwd(forward), std_bwd(backward);
+            const project2::string_view p2_fwd(forward), p2_bwd(backward);
+
+            s.run("find" + params, haystack_size,
+                  [&](std::size_t i) { return std_fwd.find(std_needle, i & 1); },
+                  [&](std::size_t i) { return p2_fwd.find(p2_needle, i & 1); });
+            s.run("rfind" + params, haystack_size,
+                  [&](std::size_t i) { return std_bwd.rfind(std_needle, haystack_size - (i & 1)); },
+                  [&](std::size_t i) { return p2_bwd.rfind(p2_needle, haystack_size - (i & 1)); });
+        }
+
+        s.run("find_first_of/set=4/haystack=" + std::to_string(haystack_size), haystack_size,
+              [&](std::size_t i) { return std_hay.find_first_of("#;{}", i & 1); },
+              [&](std::size_t i) { return p2_hay.find_first_of("#;{}", i & 1); });
+        s.run("find_first_not_of/set=26/haystack=" + std::to_string(haystack_size), haystack_size,
+              [&](std::size_t i) { return std_hay.find_first_not_of("abcdefghijklmnopqrstuvwxyz", i & 1); },
+              [&](std::size_t i) { return p2_hay.find_first_not_of("abcdefghijklmnopqrstuvwxyz", i & 1); });
+    }
+}
+
+void bench_compare(suite& s) {
+    for (std::size_t length : {16, 1024}) {
+        // Equal up to the last byte, so every byte is compared.
+        const std::string a = make_text(length, 3);
+        std::string b = a;
+        b.back() = '#';
+        const std::string_view std_a(a), std_b(b);
+        const project2::string_view p2_a(a), p2_b(b);
+        s.run("compare/length=" + std::to_string(length), length,
+              [&](std::size_t i) { return sign((i & 1 ? std_a : std_b).compare(std_a)) + 1; },
+              [&](std::size_t i) { return sign((i & 1 ? p2_a : p2_b).compare(p2_a)) + 1; });
+        s.run("equal/length=" + std::to_string(length), length,
+              [&](std::size_t i) { return (i & 1 ? std_a : std_b) == std_a; },
+              [&](std::size_t i) { return (i & 1 ? p2_a : p2_b) == p2_a; });
+    }
+}
+
+void bench_substr(suite& s) {
+    const std::string text = make_text(4096, 4);
+    const std::string_view std_text(text);
+    const project2::string_view p2_text(text);
+    s.run("substr", 0,
+          [&](std::size_t i) { return std_text.substr(i & 1023, 64).front(); },
+          [&](std::size_t i) { return p2_text.substr(i & 1023, 64).front(); });
+}
+
+void bench_iterate(suite& s) {
+    for (std::size_t length : {64, 4096}) {
+        const std::string text = make_text(length, 5);
+        const std::string_view std_text(text);
+        const project2::string_view p2_text(text);
+        s.run("iterate/length=" + std::to_string(length), length,
+              [&](std::size_t i) {
+                  std::uint64_t sum = i;
+                  for (char c : std_text) sum += static_cast<unsigned char>(c);
+                  return sum;
+              },
+              [&](std::size_t i) {
+                  std::uint64_t sum = i;
+                  for (char c : p2_text) sum += static_cast<unsigned char>(c);
+                  return sum;
+              });
+    }
+}
+
+void bench_hash(suite& s) {
+    for (std::size_t length : {8, 32, 1024}) {
+        std::vector<std::string> texts;
+        for (std::uint32_t k = 0; k < 8; ++k) texts.push_back(make_text(length, k));
+        // The hash values differ by design; only their cost is compared.
+        s.run("hash/length=" + std::to_string(length), length,
+              [&](std::size_t i) { return std::hash<std::string_view>()(texts[i & 7]) != 0; },
+              [&](std::size_t i) { return std::hash<project2::string_view>()(texts[i & 7]) != 0; });
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    output_format format = output_format::table;
+    std::string filter;
+    double min_seconds = 0.05;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--format=table") {
+            format = output_format::table;
+        } else if (arg == "--format=csv") {
+            format = output_format::csv;
+        } else if (arg == "--format=json") {
+            format = output_format::json;
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(9);
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            min_seconds = std::strtod(arg.c_str() + 11, nullptr);
+        } else {
+            std::cerr << "usage: string_view_bench [--format=table|csv|json] [--filter=TEXT] [--min-time=SECONDS]\n";
+            return 1;
+        }
+    }
+
+    suite s(min_seconds, filter);
+    bench_construct(s);
+    bench_find(s);
+    bench_compare(s);
+    bench_substr(s);
+    bench_iterate(s);
+    bench_hash(s);
+    s.print(std::cout, format);
+    return s.failed() ? 1 : 0;
+}
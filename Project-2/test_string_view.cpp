@@ -0,0 +1,438 @@
+// Behavior tests for the string_view extensions, checked against
+// std::string_view wherever the standard has the same operation.
+
+// The checks are the test; keep them in release builds.
+#undef NDEBUG
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "include/char_set.hpp"
+#include "include/intern_pool.hpp"
+#include "include/searcher.hpp"
+#include "include/split.hpp"
+#include "include/string_map.hpp"
+#include "include/string_view.hpp"
+
+using project2::string_view;
+
+namespace {
+
+constexpr std::size_t npos = string_view::npos;
+
+std::string_view std_view(string_view sv) {
+    return std::string_view(sv.data(), sv.size());
+}
+
+// Deterministic text over a small alphabet, so that needles have many
+// partial matches. Held in a vector of exactly n bytes, so that reading past
+// the end of the haystack is caught by the sanitizers.
+std::vector<char> make_text(std::size_t n, const std::string& alphabet, std::uint32_t seed) {
+    std::vector<char> text(n);
+    for (char& c : text) {
+        seed = seed * 1664525u + 1013904223u;
+        c = alphabet[(seed >> 24) % alphabet.size()];
+    }
+    return text;
+}
+
+string_view view_of(const std::vector<char>& text) {
+    return string_view(text.data(), text.size());
+}
+
+// Haystack lengths around the 16- and 32-byte SIMD blocks
+const std::size_t text_lengths[] = {0, 1, 2, 15, 16, 17, 31, 32, 33, 63, 64, 65, 150, 300};
+
+// Needle lengths: empty, one byte, the SIMD pair filter, and the Horspool
+// threshold
+const std::size_t needle_lengths[] = {0, 1, 2, 3, 15, 16, 17, 31, 32, 33,
+                                      project2::detail::horspool_threshold - 1,
+                                      project2::detail::horspool_threshold,
+                                      project2::detail::horspool_threshold + 1};
+
+// Needles cut from the haystack at block boundaries and at its tail, plus a
+// variant of each that does not occur
+std::vector<std::string> needles_for(string_view text, std::size_t m) {
+    std::vector<std::string> needles;
+    if (m > text.size()) {
+        needles.push_back(std::string(m, 'a'));
+        return needles;
+    }
+    for (std::size_t start : {std::size_t(0), std::size_t(1), std::size_t(15), std::size_t(16), std::size_t(17),
+                              std::size_t(31), std::size_t(32), std::size_t(33), text.size() - m}) {
+        if (start + m <= text.size()) {
+            needles.push_back(std::string(text.data() + start, m));
+        }
+    }
+    if (m > 0) {
+        std::string absent(text.data() + (text.size() - m), m);
+        absent.back() = 'z';
+        needles.push_back(absent);
+    }
+    return needles;
+}
+
+std::vector<std::size_t> positions_for(std::size_t n) {
+    std::vector<std::size_t> positions = {0, 1, 15, 16, 17, 31, 32, 33, n / 2, n, n + 1, npos};
+    if (n > 0) positions.push_back(n - 1);
+    return positions;
+}
+
+// The leftmost match of any needle, the first listed winning ties
+std::pair<std::size_t, std::size_t> naive_find_any(std::string_view text, const std::vector<std::string>& needles,
+                                                   std::size_t pos) {
+    std::pair<std::size_t, std::size_t> best(npos, 0);
+    for (std::size_t i = 0; i < needles.size(); ++i) {
+        const std::size_t p = text.find(needles[i], pos);
+        if (p < best.first) best = {p, i};
+    }
+    return best;
+}
+
+template <typename Range>
+std::vector<std::string> tokens_of(const Range& range) {
+    std::vector<std::string> tokens;
+    for (string_view token : range) tokens.push_back(std::string(token.data(), token.size()));
+    return tokens;
+}
+
+// Splitting with the same rules as split(): no tokens for an empty text, an
+// empty token between adjacent delimiters and after a trailing one
+std::vector<std::string> naive_split(const std::string& text, const std::string& delimiter) {
+    std::vector<std::string> tokens;
+    if (text.empty()) return tokens;
+    if (delimiter.empty()) {
+        for (char c : text) tokens.push_back(std::string(1, c));
+        return tokens;
+    }
+    std::size_t begin = 0;
+    for (;;) {
+        const std::size_t found = text.find(delimiter, begin);
+        if (found == std::string::npos) break;
+        tokens.push_back(text.substr(begin, found - begin));
+        begin = found + delimiter.size();
+    }
+    tokens.push_back(text.substr(begin));
+    return tokens;
+}
+
+void print_separator(const std::string& title) {
+    std::cout << "\n=== " << title << " ===\n";
+}
+
+} // namespace
+
+int main() {
+    // Test 1: searcher and string_view::find / rfind against std::string_view
+    print_separator("Test 1: searcher");
+    std::size_t searches = 0;
+    for (std::size_t n : text_lengths) {
+        const std::vector<char> buffer = make_text(n, "ab", static_cast<std::uint32_t>(n));
+        const string_view text = view_of(buffer);
+        for (std::size_t m : needle_lengths) {
+            for (const std::string& needle : needles_for(text, m)) {
+                const project2::searcher s(needle);
+                assert(std_view(s.needle()) == needle);
+                for (std::size_t pos : positions_for(n)) {
+                    const std::size_t expected_find = std_view(text).find(needle, pos);
+                    const std::size_t expected_rfind = std_view(text).rfind(needle, pos);
+                    assert(text.find(s, pos) == expected_find);
+                    assert(text.rfind(s, pos) == expected_rfind);
+                    assert(text.find(string_view(needle), pos) == expected_find);
+                    assert(text.rfind(string_view(needle), pos) == expected_rfind);
+                    searches += 4;
+                }
+            }
+        }
+    }
+    {
+        // The searcher owns its needle
+        std::string temporary = "needle";
+        const project2::searcher s(temporary);
+        temporary.assign("xxxxxx");
+        assert(string_view("haystack with a needle").find(s) == 16);
+        assert(string_view("needle, needle").rfind(s, 7) == 0);
+    }
+    std::cout << "✓ " << searches << " searches match std::string_view\n";
+
+    // Test 2: multi_searcher reports the leftmost match and which needle
+    print_separator("Test 2: multi_searcher");
+    const std::vector<char> multi_buffer = make_text(300, "abc", 7);
+    const string_view multi_text = view_of(multi_buffer);
+    std::vector<std::string> many;
+    for (std::size_t i = 0; i < 20; ++i) {
+        many.push_back(std::string(multi_text.data() + 13 * i, 3 + i % 5));
+    }
+    many.push_back("zzz");
+    const std::vector<std::vector<std::string>> needle_sets = {
+        {"abc"},
+        {"ca", "zz", "b"},
+        {"aaab", "aaa", "aa"},                 // prefixes of each other
+        {"bcb", "bcb", "a"},                   // a duplicate: the first is reported
+        {"zzz", "", "ab"},                     // an empty needle matches at pos
+        {std::string(multi_text.data() + 280, 20), "q"},  // a match at the tail
+        many,                                  // past the filter limit: bucketed
+    };
+    for (const std::vector<std::string>& needles : needle_sets) {
+        const project2::multi_searcher s(needles.begin(), needles.end());
+        assert(s.size() == needles.size());
+        for (std::size_t i = 0; i < needles.size(); ++i) assert(std_view(s.needle(i)) == needles[i]);
+        const project2::multi_searcher copy = s;
+        for (std::size_t pos : positions_for(multi_text.size())) {
+            const std::pair<std::size_t, std::size_t> expected = naive_find_any(std_view(multi_text), needles, pos);
+            const project2::multi_searcher::match found = s.find_in(multi_text, pos);
+            assert(found.position == expected.first);
+            if (found.position != npos) assert(found.needle == expected.second);
+            assert(copy.find_in(multi_text, pos).position == expected.first);
+            assert(multi_text.find(s, pos) == expected.first);
+        }
+    }
+    {
+        const project2::multi_searcher keywords = {"static_cast", "dynamic_cast", "const_cast"};
+        const project2::multi_searcher::match found = keywords.find_in("x = const_cast<int*>(p);");
+        assert(found.position == 4 && found.needle == 2);
+        assert(keywords.find_in("no casts here").position == npos);
+    }
+    std::cout << "✓ " << needle_sets.size() << " needle sets match a naive search\n";
+
+    // Test 3: find_first_of / find_last_of and the *_not_of variants
+    print_separator("Test 3: Character Set Searches");
+    const std::string set_alphabet = std::string("abcxyz \t") + '\xe9' + '\x80';
+    const std::vector<std::string> sets = {
+        "",                                 // matches nothing
+        "a",                                // one character: plain find
+        "ab",
+        " \t",
+        std::string("z") + '\xe9',          // a byte above 0x7f
+        std::string(1, '\x80'),
+        "abcdefghijklmnopqrstuvwxyz",       // most of the text
+        set_alphabet,                       // all of it
+    };
+    std::size_t set_searches = 0;
+    for (std::size_t n : text_lengths) {
+        const std::vector<char> buffer = make_text(n, set_alphabet, static_cast<std::uint32_t>(n * 31 + 1));
+        const string_view text = view_of(buffer);
+        const std::string_view expected_text = std_view(text);
+        for (const std::string& chars : sets) {
+            const project2::char_set set(chars.data(), chars.size());
+            const string_view chars_view(chars);
+            for (std::size_t pos : positions_for(n)) {
+                assert(text.find_first_of(set, pos) == expected_text.find_first_of(chars, pos));
+                assert(text.find_first_of(chars_view, pos) == expected_text.find_first_of(chars, pos));
+                assert(text.find_last_of(set, pos) == expected_text.find_last_of(chars, pos));
+                assert(text.find_last_of(chars_view, pos) == expected_text.find_last_of(chars, pos));
+                assert(text.find_first_not_of(set, pos) == expected_text.find_first_not_of(chars, pos));
+                assert(text.find_first_not_of(chars_view, pos) == expected_text.find_first_not_of(chars, pos));
+                assert(text.find_last_not_of(set, pos) == expected_text.find_last_not_of(chars, pos));
+                assert(text.find_last_not_of(chars_view, pos) == expected_text.find_last_not_of(chars, pos));
+                set_searches += 8;
+            }
+        }
+        for (std::size_t pos : positions_for(n)) {
+            assert(text.find_first_of('\xe9', pos) == expected_text.find_first_of('\xe9', pos));
+            assert(text.find_last_of('\xe9', pos) == expected_text.find_last_of('\xe9', pos));
+            assert(text.find_first_not_of('a', pos) == expected_text.find_first_not_of('a', pos));
+            assert(text.find_last_not_of('a', pos) == expected_text.find_last_not_of('a', pos));
+            set_searches += 4;
+        }
+    }
+    {
+        // The only match is the last byte of a block or of the text
+        for (std::size_t n : {std::size_t(16), std::size_t(32), std::size_t(33), std::size_t(64)}) {
+            std::vector<char> buffer(n, 'a');
+            buffer.back() = ';';
+            const string_view text = view_of(buffer);
+            const project2::char_set separators(";,");
+            assert(text.find_first_of(separators) == n - 1);
+            assert(text.find_last_of(separators) == n - 1);
+            assert(text.find_first_not_of("a") == n - 1);
+            assert(text.find_last_not_of(separators) == n - 2);
+            buffer[n / 2] = ',';
+            assert(text.find_first_of(separators) == n / 2);
+            assert(text.find_last_of(separators, n - 2) == n / 2);
+        }
+        const project2::char_set from_literal("aeiou");
+        assert(from_literal.contains('e') && !from_literal.contains('y'));
+    }
+    std::cout << "✓ " << set_searches << " character set searches match std::string_view\n";
+
+    // Test 4: split
+    print_separator("Test 4: split");
+    using tokens = std::vector<std::string>;
+    assert(tokens_of(project2::split("a,b,,c", ',')) == (tokens{"a", "b", "", "c"}));
+    assert(tokens_of(project2::split("a,b,", ',')) == (tokens{"a", "b", ""}));    // trailing delimiter
+    assert(tokens_of(project2::split(",a", ',')) == (tokens{"", "a"}));
+    assert(tokens_of(project2::split(",", ',')) == (tokens{"", ""}));
+    assert(tokens_of(project2::split(",,", ',')) == (tokens{"", "", ""}));
+    assert(tokens_of(project2::split("", ',')).empty());                        // no tokens at all
+    assert(tokens_of(project2::split("abc", ',')) == (tokens{"abc"}));
+    assert(tokens_of(project2::split("a, b, , c, ", ", ")) == (tokens{"a", "b", "", "c", ""}));
+    assert(tokens_of(project2::split("a,,b", ",,,")) == (tokens{"a,,b"}));        // longer than the text
+    assert(tokens_of(project2::split("abc", "")) == (tokens{"a", "b", "c"}));
+    assert(tokens_of(project2::split("a b\tc \t", project2::char_set(" \t"))) ==
+           (tokens{"a", "b", "c", "", ""}));
+    for (const std::string& text : {std::string("x;y;;z;"), std::string(";;"), std::string("no delimiter"),
+                                    std::string(40, ';'), std::string("a;") + std::string(33, 'b') + ";"}) {
+        assert(tokens_of(project2::split(text, ';')) == naive_split(text, ";"));
+        assert(tokens_of(project2::split(text, ";;")) == naive_split(text, ";;"));
+        assert(tokens_of(project2::split(text, project2::char_set(";"))) == naive_split(text, ";"));
+    }
+    {
+        // Tokens are views into the text, and iterators are forward iterators
+        const std::string text = "key=value=more";
+        const auto fields = project2::split(text, '=');
+        auto it = fields.begin();
+        assert(it->data() == text.data() && it->size() == 3);
+        const auto first = it++;
+        assert(*first == string_view("key") && *it == string_view("value"));
+        assert(it->data() == text.data() + 4);
+        ++it;
+        assert(*it == string_view("more") && ++it == fields.end());
+        assert(std::distance(fields.begin(), fields.end()) == 3);
+        assert(fields.text().data() == text.data());
+    }
+    std::cout << "✓ split matches the std::views::split rules\n";
+
+    // Test 5: string_map and string_key
+    print_separator("Test 5: string_map");
+    {
+        // A borrowed key points at the caller's characters, an owned one copies them
+        const std::string source = "borrowed";
+        const project2::string_key borrowed(source);
+        const project2::string_key owned = project2::string_key::copy_of(source);
+        assert(borrowed.view().data() == source.data());
+        assert(owned.view().data() != source.data() && owned.view() == borrowed.view());
+        const project2::string_key borrowed_copy = borrowed;
+        const project2::string_key owned_copy = owned;
+        assert(borrowed_copy.view().data() == source.data());
+        assert(owned_copy.view().data() != owned.view().data() && owned_copy.view() == string_view("borrowed"));
+        assert(project2::string_key::copy_of("").view().empty());
+
+        const project2::string_hash hash;
+        assert(hash(source) == hash(string_view(source)) && hash(source.c_str()) == hash(borrowed.view()));
+    }
+    {
+        project2::string_map<int> counts;
+        {
+            // Inserted keys outlive the strings they were made from
+            std::string word = "alpha";
+            counts["alpha"] = 1;
+            word = "beta";
+            counts.try_emplace(word, 2);
+            word.assign(30, 'g');
+            counts.insert_or_assign(word, 3);
+            word.assign(30, 'x');
+        }
+        assert(counts.size() == 3);
+        assert(counts.at("alpha") == 1 && counts.at("beta") == 2 && counts.at(std::string(30, 'g')) == 3);
+
+        // Lookups with views of other buffers find the stored keys
+        const char buffer[] = "xx beta xx";
+        const string_view beta(buffer + 3, 4);
+        assert(counts.contains(beta) && counts.count(beta) == 1 && counts.find(beta)->second == 2);
+        assert(!counts.contains(string_view(buffer, 4)));
+        assert(counts.find(beta)->first.view().data() != buffer + 3);
+
+        assert(!counts.try_emplace("beta", 20).second && counts.at("beta") == 2);
+        assert(!counts.insert_or_assign("beta", 20).second && counts.at("beta") == 20);
+        ++counts["gamma"];
+        assert(counts.at("gamma") == 1);
+
+        bool threw = false;
+        try {
+            counts.at("missing");
+        } catch (const std::out_of_range&) {
+            threw = true;
+        }
+        assert(threw);
+
+        const project2::string_map<int> copy = counts;
+        assert(counts.erase(beta) == 1 && counts.erase(beta) == 0 && !counts.contains("beta"));
+        assert(copy.size() == 4 && copy.at("beta") == 20);
+        counts.erase(counts.find("alpha"));
+        assert(counts.size() == 2 && !counts.contains("alpha"));
+    }
+    std::cout << "✓ string_map stores owned keys and finds them with borrowed ones\n";
+
+    // Test 6: intern_pool and sharded_intern_pool
+    print_separator("Test 6: intern_pool");
+    {
+        project2::intern_pool pool(256);
+        std::string word = "alpha";
+        const string_view alpha = pool.intern(word);
+        word = "scratch";
+        assert(alpha == string_view("alpha") && alpha.data() != word.data());
+        assert(alpha.data()[alpha.size()] == '\0');
+
+        // Ids count up from 0 and stay fixed; the same string gives the same view
+        assert(pool.id("alpha") == 0 && pool.id("beta") == 1 && pool.id("gamma") == 2);
+        assert(pool.id("alpha") == 0 && pool.intern("alpha").data() == alpha.data());
+        assert(pool.intern(std::string("beta")).data() == pool[1].data());
+        assert(pool.find("gamma") == 2 && pool.find("delta") == project2::intern_pool::no_id);
+        assert(pool.size() == 3 && pool.intern("").empty() && pool.size() == 4);
+
+        // A string over a quarter of the block gets a block of its own, and
+        // the shared block keeps filling after it
+        const std::size_t shared_before = pool.capacity_bytes();
+        const std::string long_string(100, 'L');
+        const string_view stored_long = pool.intern(long_string);
+        assert(pool.capacity_bytes() == shared_before + long_string.size() + 1);
+        const string_view after_long = pool.intern("after");
+        assert(pool.capacity_bytes() == shared_before + long_string.size() + 1);
+        assert(after_long.data() > alpha.data() && after_long.data() < alpha.data() + 256);
+
+        // Filling the shared block opens another; old views stay valid
+        std::vector<string_view> filler;
+        for (int i = 0; i < 100; ++i) filler.push_back(pool.intern("filler" + std::to_string(i)));
+        assert(pool.capacity_bytes() > shared_before + 256);
+        assert(alpha == string_view("alpha") && stored_long == string_view(long_string));
+        assert(filler[0] == string_view("filler0") && filler[99] == string_view("filler99"));
+
+        // Moving keeps ids and views; the moved-from pool starts over empty
+        project2::intern_pool moved(std::move(pool));
+        assert(moved.id("alpha") == 0 && moved.intern("after").data() == after_long.data());
+        assert(pool.size() == 0 && pool.capacity_bytes() == 0 && pool.find("alpha") == project2::intern_pool::no_id);
+        const string_view reused = pool.intern("alpha");
+        assert(pool.id("alpha") == 0 && reused == string_view("alpha"));
+        assert(reused.data() != alpha.data());
+        const string_view next_in_moved = moved.intern("next");
+        assert(next_in_moved != reused && reused == string_view("alpha") && next_in_moved == string_view("next"));
+
+        project2::intern_pool assigned;
+        assigned.intern("to be replaced");
+        assigned = std::move(moved);
+        assert(assigned.size() == 107 && assigned[0].data() == alpha.data());
+        assert(moved.size() == 0 && moved.intern("fresh") == string_view("fresh") && moved.id("fresh") == 0);
+        assert(assigned.intern("x") == string_view("x") && assigned.find("fresh") == project2::intern_pool::no_id);
+    }
+    {
+        project2::sharded_intern_pool shared(1024);
+        std::vector<std::thread> threads;
+        std::vector<std::vector<project2::sharded_intern_pool::id_type>> ids(4);
+        for (std::size_t t = 0; t < ids.size(); ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 200; ++i) ids[t].push_back(shared.id("word" + std::to_string(i)));
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        assert(shared.size() == 200);
+        for (std::size_t t = 1; t < ids.size(); ++t) assert(ids[t] == ids[0]);
+        for (int i = 0; i < 200; ++i) {
+            const std::string word = "word" + std::to_string(i);
+            assert(shared[ids[0][i]] == string_view(word) && shared.find(word) == ids[0][i]);
+            assert(shared.intern(word).data() == shared[ids[0][i]].data());
+        }
+        assert(shared.find("absent") == project2::sharded_intern_pool::no_id);
+    }
+    std::cout << "✓ intern_pool keeps ids and views stable, across moves too\n";
+
+    print_separator("All Tests Passed!");
+    return 0;
+}
@@ -1,10 +1,13 @@
 #ifndef OPTIONAL_HPP
 #define OPTIONAL_HPP
 
+#include <functional>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 #include <type_traits>
 #include <new>
+#include <cstdint>
 
 // Nullopt type to represent an empty optional
 struct nullopt_t {};
@@ -24,8 +27,14 @@ class optional;
 struct in_place_t {};
 constexpr in_place_t in_place{};
 
-// Storage for optional
-template <typename T>
+// Tag for constructing the value straight from the result of a call, so that
+// transform() neither copies nor moves what the function returns
+struct optional_invoke_t {};
+constexpr optional_invoke_t optional_invoke{};
+
+// Storage for optional. The destructor is left implicit -- and so trivial --
+// when T's is, which lets optional<T> be trivially destructible too.
+template <typename T, bool = std::is_trivially_destructible_v<T>>
 union optional_storage {
     char dummy;
     T value;
@@ -33,10 +42,30 @@ union optional_storage {
     constexpr optional_storage() : dummy('\0') {}
     constexpr optional_storage(const T& v) : value(v) {}
     constexpr optional_storage(T&& v) : value(std::move(v)) {}
+    template <typename... Args>
+    constexpr explicit optional_storage(in_place_t, Args&&... args) : value(std::forward<Args>(args)...) {}
+    template <typename F, typename... Args>
+    constexpr optional_storage(optional_invoke_t, F&& f, Args&&... args)
+        : value(std::invoke(std::forward<F>(f), std::forward<Args>(args)...)) {}
 
     ~optional_storage() {}
 };
 
+template <typename T>
+union optional_storage<T, true> {
+    char dummy;
+    T value;
+
+    constexpr optional_storage() : dummy('\0') {}
+    constexpr optional_storage(const T& v) : value(v) {}
+    constexpr optional_storage(T&& v) : value(std::move(v)) {}
+    template <typename... Args>
+    constexpr explicit optional_storage(in_place_t, Args&&... args) : value(std::forward<Args>(args)...) {}
+    template <typename F, typename... Args>
+    constexpr optional_storage(optional_invoke_t, F&& f, Args&&... args)
+        : value(std::invoke(std::forward<F>(f), std::forward<Args>(args)...)) {}
+};
+
 // Template specialization for void (empty storage)
 template <>
 union optional_storage<void> {
@@ -46,101 +75,252 @@ union optional_storage<void> {
     ~optional_storage() {}
 };
 
-// Main optional class
+// Customization point for storing emptiness inside T itself.
+//
+// A type with a value it never holds in practice can name that value as a
+// sentinel meaning "empty"; optional<T> then has no engaged flag and is
+// exactly sizeof(T). A specialization provides
+//
+//     static constexpr bool enabled = true;
+//     static T empty_value() noexcept;    // the sentinel, constexpr if possible
+//
+// Pointers are covered out of the box, with the all-ones address (never that
+// of a real object) as the sentinel, so a null pointer is still an ordinary
+// value. Enumerations and other types that can be template arguments opt in
+// with optional_niche_value:
+//
+//     enum class slot : std::uint32_t { none = 0xffffffff };
+//     template <>
+//     struct optional_niche<slot> : optional_niche_value<slot, slot::none> {};
+//
+// Engaging an optional with the sentinel itself leaves it empty.
 template <typename T>
-class optional {
-public:
-    using value_type = T;
+struct optional_niche {
+    static constexpr bool enabled = false;
+};
 
-    // Default constructor - creates an empty optional
-    constexpr optional() noexcept : storage_(), has_value_(false) {}
+template <typename T, T Empty>
+struct optional_niche_value {
+    static constexpr bool enabled = true;
+    static constexpr T empty_value() noexcept { return Empty; }
+};
 
-    // Destructor
-    ~optional() noexcept {
-        if (has_value_) {
-            storage_.value.~T();
-        }
+template <typename T>
+struct optional_niche<T*> {
+    static constexpr bool enabled = true;
+    static T* empty_value() noexcept { return reinterpret_cast<T*>(~std::uintptr_t(0)); }
+};
+
+// The storage together with the engaged flag.
+//
+// For trivially copyable, trivially destructible T every special member is
+// left implicit, so optional<T> is trivially copyable as well: copies are a
+// plain memcpy of the value and the flag, and containers may relocate
+// elements with memmove. Other types get copy, move and destruction that
+// construct or destroy the value only when one is present.
+//
+// This is a member of optional rather than a base class: a base subobject
+// may share its tail padding, so its copies move the fields one by one
+// instead of as a single block the size of the whole object.
+template <typename T, bool = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>>
+struct optional_payload {
+    constexpr optional_payload() noexcept : storage_(), has_value_(false) {}
+
+    template <typename... Args>
+    constexpr explicit optional_payload(in_place_t, Args&&... args) noexcept(
+        std::is_nothrow_constructible_v<T, Args...>)
+        : storage_(in_place, std::forward<Args>(args)...), has_value_(true) {}
+
+    template <typename F, typename... Args>
+    constexpr optional_payload(optional_invoke_t tag, F&& f, Args&&... args)
+        : storage_(tag, std::forward<F>(f), std::forward<Args>(args)...), has_value_(true) {}
+
+    constexpr bool has_value() const noexcept { return has_value_; }
+
+    // Precondition: empty.
+    template <typename... Args>
+    void construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        new (&storage_.value) T(std::forward<Args>(args)...);
+        has_value_ = true;
     }
 
-    // Constructor from nullopt
-    constexpr optional(nullopt_t) noexcept : storage_(), has_value_(false) {}
+    // Precondition: engaged.
+    void destroy() noexcept { has_value_ = false; }
 
-    // Copy constructor
-    optional(const optional& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
-        : has_value_(other.has_value_) {
-        if (other.has_value_) {
-            new (&storage_.value) T(other.storage_.value);
+    optional_storage<T> storage_;
+    bool has_value_;
+};
+
+template <typename T>
+struct optional_payload<T, false> {
+    constexpr optional_payload() noexcept : storage_(), has_value_(false) {}
+
+    template <typename... Args>
+    constexpr explicit optional_payload(in_place_t, Args&&... args) noexcept(
+        std::is_nothrow_constructible_v<T, Args...>)
+        : storage_(in_place, std::forward<Args>(args)...), has_value_(true) {}
+
+    template <typename F, typename... Args>
+    constexpr optional_payload(optional_invoke_t tag, F&& f, Args&&... args)
+        : storage_(tag, std::forward<F>(f), std::forward<Args>(args)...), has_value_(true) {}
+
+    ~optional_payload() noexcept {
+        if (has_value_) {
+            storage_.value.~T();
         }
     }
 
-    // Move constructor
-    optional(optional&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
-        : has_value_(other.has_value_) {
+    optional_payload(const optional_payload& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        : storage_(), has_value_(false) {
         if (other.has_value_) {
-            new (&storage_.value) T(std::move(other.storage_.value));
+            construct(other.storage_.value);
         }
     }
 
-    // Constructor from value
-    template <typename U = T,
-              typename = std::enable_if_t<!std::is_same_v<std::decay_t<U>, optional>>>
-    constexpr optional(U&& value) noexcept(std::is_nothrow_constructible_v<T, U>)
-        : storage_(std::forward<U>(value)), has_value_(true) {}
-
-    // Constructor from optional<U>
-    template <typename U,
-              typename = std::enable_if_t<std::is_constructible_v<T, const U&> &&
-                                          !std::is_constructible_v<T, optional<U>&> &&
-                                          !std::is_constructible_v<T, optional<U>&&> &&
-                                          !std::is_convertible_v<optional<U>&, T> &&
-                                          !std::is_convertible_v<optional<U>&&, T>>>
-    optional(const optional<U>& other) noexcept(std::is_nothrow_constructible_v<T, const U&>) {
-        if (other) {
-            storage_.value = T(*other);
-            has_value_ = true;
+    optional_payload(optional_payload&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : storage_(), has_value_(false) {
+        if (other.has_value_) {
+            construct(std::move(other.storage_.value));
         }
     }
 
-    // In-place constructor
-    template <typename... Args>
-    constexpr explicit optional(in_place_t, Args&&... args) noexcept(
-        std::is_nothrow_constructible_v<T, Args...>)
-        : has_value_(true) {
-        new (&storage_.value) T(std::forward<Args>(args)...);
-    }
-
-    // Copy assignment
-    optional& operator=(const optional& other) noexcept(
+    optional_payload& operator=(const optional_payload& other) noexcept(
         std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_assignable_v<T>) {
         if (this != &other) {
             if (has_value_ && other.has_value_) {
                 storage_.value = other.storage_.value;
             } else if (other.has_value_) {
-                new (&storage_.value) T(other.storage_.value);
-                has_value_ = true;
-            } else {
-                reset();
+                construct(other.storage_.value);
+            } else if (has_value_) {
+                destroy();
             }
         }
         return *this;
     }
 
-    // Move assignment
-    optional& operator=(optional&& other) noexcept(
+    optional_payload& operator=(optional_payload&& other) noexcept(
         std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
         if (this != &other) {
             if (has_value_ && other.has_value_) {
                 storage_.value = std::move(other.storage_.value);
             } else if (other.has_value_) {
-                new (&storage_.value) T(std::move(other.storage_.value));
-                has_value_ = true;
-            } else {
-                reset();
+                construct(std::move(other.storage_.value));
+            } else if (has_value_) {
+                destroy();
             }
         }
         return *this;
     }
 
+    constexpr bool has_value() const noexcept { return has_value_; }
+
+    // Precondition: empty.
+    template <typename... Args>
+    void construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        new (&storage_.value) T(std::forward<Args>(args)...);
+        has_value_ = true;
+    }
+
+    // Precondition: engaged.
+    void destroy() noexcept {
+        storage_.value.~T();
+        has_value_ = false;
+    }
+
+    optional_storage<T> storage_;
+    bool has_value_;
+};
+
+// Payload for types with an optional_niche: the value is always live, and
+// holding the sentinel is what makes the optional empty.
+template <typename T>
+struct optional_niche_payload {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "optional_niche is only supported for trivially copyable types");
+
+    constexpr optional_niche_payload() noexcept : storage_(optional_niche<T>::empty_value()) {}
+
+    template <typename... Args>
+    constexpr explicit optional_niche_payload(in_place_t, Args&&... args) noexcept(
+        std::is_nothrow_constructible_v<T, Args...>)
+        : storage_(in_place, std::forward<Args>(args)...) {}
+
+    template <typename F, typename... Args>
+    constexpr optional_niche_payload(optional_invoke_t tag, F&& f, Args&&... args)
+        : storage_(tag, std::forward<F>(f), std::forward<Args>(args)...) {}
+
+    constexpr bool has_value() const noexcept { return !(storage_.value == optional_niche<T>::empty_value()); }
+
+    template <typename... Args>
+    void construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        new (&storage_.value) T(std::forward<Args>(args)...);
+    }
+
+    void destroy() noexcept { storage_.value = optional_niche<T>::empty_value(); }
+
+    optional_storage<T> storage_;
+};
+
+template <typename T>
+using optional_payload_t =
+    std::conditional_t<optional_niche<T>::enabled, optional_niche_payload<T>, optional_payload<T>>;
+
+// Whether T is a specialization of optional; and_then() requires its
+// function to return one
+template <typename T>
+struct is_optional : std::false_type {};
+
+template <typename T>
+struct is_optional<optional<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_optional_v = is_optional<T>::value;
+
+// Main optional class
+template <typename T>
+class optional {
+public:
+    using value_type = T;
+
+    // Default constructor - creates an empty optional
+    constexpr optional() noexcept : payload_() {}
+
+    // Constructor from nullopt
+    constexpr optional(nullopt_t) noexcept : payload_() {}
+
+    // Copy and move construction and assignment, and destruction, come from
+    // optional_payload: trivial when T is trivially copyable.
+    optional(const optional&) = default;
+    optional(optional&&) = default;
+    optional& operator=(const optional&) = default;
+    optional& operator=(optional&&) = default;
+
+    // Constructor from value
+    template <typename U = T,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<U>, optional> &&
+                                          std::is_constructible_v<T, U&&>>>
+    constexpr optional(U&& value) noexcept(std::is_nothrow_constructible_v<T, U>)
+        : payload_(in_place, std::forward<U>(value)) {}
+
+    // Constructor from optional<U>
+    template <typename U,
+              typename = std::enable_if_t<std::is_constructible_v<T, const U&> &&
+                                          !std::is_constructible_v<T, optional<U>&> &&
+                                          !std::is_constructible_v<T, optional<U>&&> &&
+                                          !std::is_convertible_v<optional<U>&, T> &&
+                                          !std::is_convertible_v<optional<U>&&, T>>>
+    optional(const optional<U>& other) noexcept(std::is_nothrow_constructible_v<T, const U&>) : payload_() {
+        if (other) {
+            payload_.construct(*other);
+        }
+    }
+
+    // In-place constructor
+    template <typename... Args>
+    constexpr explicit optional(in_place_t, Args&&... args) noexcept(
+        std::is_nothrow_constructible_v<T, Args...>)
+        : payload_(in_place, std::forward<Args>(args)...) {}
+
     // Assignment from nullopt
     optional& operator=(nullopt_t) noexcept {
         reset();
@@ -151,98 +331,167 @@ public:
     template <typename U = T,
               typename = std::enable_if_t<!std::is_same_v<std::decay_t<U>, optional>>>
     optional& operator=(U&& value) noexcept(std::is_nothrow_assignable_v<T&, U>) {
-        if (has_value_) {
-            storage_.value = std::forward<U>(value);
+        if (payload_.has_value()) {
+            payload_.storage_.value = std::forward<U>(value);
         } else {
-            new (&storage_.value) T(std::forward<U>(value));
-            has_value_ = true;
+            payload_.construct(std::forward<U>(value));
         }
         return *this;
     }
 
     // Observers
-    constexpr const T* operator->() const noexcept { return &storage_.value; }
+    constexpr const T* operator->() const noexcept { return &payload_.storage_.value; }
 
-    constexpr T* operator->() noexcept { return &storage_.value; }
+    constexpr T* operator->() noexcept { return &payload_.storage_.value; }
 
-    constexpr const T& operator*() const& noexcept { return storage_.value; }
+    constexpr const T& operator*() const& noexcept { return payload_.storage_.value; }
 
-    constexpr T& operator*() & noexcept { return storage_.value; }
+    constexpr T& operator*() & noexcept { return payload_.storage_.value; }
 
-    constexpr const T&& operator*() const&& noexcept { return std::move(storage_.value); }
+    constexpr const T&& operator*() const&& noexcept { return std::move(payload_.storage_.value); }
 
-    constexpr T&& operator*() && noexcept { return std::move(storage_.value); }
+    constexpr T&& operator*() && noexcept { return std::move(payload_.storage_.value); }
 
     // Conversion to bool
-    constexpr explicit operator bool() const noexcept { return has_value_; }
+    constexpr explicit operator bool() const noexcept { return payload_.has_value(); }
 
-    constexpr bool has_value() const noexcept { return has_value_; }
+    constexpr bool has_value() const noexcept { return payload_.has_value(); }
 
     // Value access
     constexpr T& value() & {
-        if (!has_value_) {
+        if (!payload_.has_value()) {
             throw bad_optional_access();
         }
-        return storage_.value;
+        return payload_.storage_.value;
     }
 
     constexpr const T& value() const& {
-        if (!has_value_) {
+        if (!payload_.has_value()) {
             throw bad_optional_access();
         }
-        return storage_.value;
+        return payload_.storage_.value;
     }
 
     constexpr T&& value() && {
-        if (!has_value_) {
+        if (!payload_.has_value()) {
             throw bad_optional_access();
         }
-        return std::move(storage_.value);
+        return std::move(payload_.storage_.value);
     }
 
     constexpr const T&& value() const&& {
-        if (!has_value_) {
+        if (!payload_.has_value()) {
             throw bad_optional_access();
         }
-        return std::move(storage_.value);
+        return std::move(payload_.storage_.value);
     }
 
     // Value or default
     template <typename U>
     constexpr T value_or(U&& default_value) const& {
-        return has_value_ ? storage_.value : static_cast<T>(std::forward<U>(default_value));
+        return payload_.has_value() ? payload_.storage_.value
+                                    : static_cast<T>(std::forward<U>(default_value));
     }
 
     template <typename U>
     constexpr T value_or(U&& default_value) && {
-        return has_value_ ? std::move(storage_.value)
-                          : static_cast<T>(std::forward<U>(default_value));
+        return payload_.has_value() ? std::move(payload_.storage_.value)
+                                    : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    // Lazy default: f() is called only when the optional is empty
+    template <typename F>
+    constexpr T value_or_else(F&& f) const& {
+        return payload_.has_value() ? payload_.storage_.value : static_cast<T>(std::invoke(std::forward<F>(f)));
+    }
+
+    template <typename F>
+    constexpr T value_or_else(F&& f) && {
+        return payload_.has_value() ? std::move(payload_.storage_.value)
+                                    : static_cast<T>(std::invoke(std::forward<F>(f)));
+    }
+
+    // Monadic operations. Each is overloaded on the value category of
+    // *this, so a chain of temporaries hands the value along by rvalue
+    // reference and never copies it.
+
+    // f(value) if engaged, otherwise an empty optional; f must return an optional
+    template <typename F>
+    constexpr auto and_then(F&& f) & {
+        return and_then_impl(*this, std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto and_then(F&& f) const& {
+        return and_then_impl(*this, std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto and_then(F&& f) && {
+        return and_then_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto and_then(F&& f) const&& {
+        return and_then_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    // optional holding f(value) if engaged, otherwise an empty one. The
+    // result of f is constructed in place.
+    template <typename F>
+    constexpr auto transform(F&& f) & {
+        return transform_impl(*this, std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto transform(F&& f) const& {
+        return transform_impl(*this, std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto transform(F&& f) && {
+        return transform_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr auto transform(F&& f) const&& {
+        return transform_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    // *this if engaged, otherwise f(); f must return optional<T>
+    template <typename F>
+    constexpr optional or_else(F&& f) const& {
+        static_assert(std::is_same_v<std::decay_t<std::invoke_result_t<F>>, optional>,
+                      "or_else: the function must return optional<T>");
+        return payload_.has_value() ? *this : std::invoke(std::forward<F>(f));
+    }
+
+    template <typename F>
+    constexpr optional or_else(F&& f) && {
+        static_assert(std::is_same_v<std::decay_t<std::invoke_result_t<F>>, optional>,
+                      "or_else: the function must return optional<T>");
+        return payload_.has_value() ? std::move(*this) : std::invoke(std::forward<F>(f));
     }
 
     // Swap
     void swap(optional& other) noexcept(std::is_nothrow_swappable_v<T> &&
                                         std::is_nothrow_move_constructible_v<T>) {
         using std::swap;
-        if (has_value_ && other.has_value_) {
-            swap(storage_.value, other.storage_.value);
-        } else if (has_value_) {
-            new (&other.storage_.value) T(std::move(storage_.value));
-            storage_.value.~T();
-            other.has_value_ = true;
-            has_value_ = false;
-        } else if (other.has_value_) {
-            new (&storage_.value) T(std::move(other.storage_.value));
-            other.storage_.value.~T();
-            has_value_ = true;
-            other.has_value_ = false;
+        if (payload_.has_value() && other.payload_.has_value()) {
+            swap(payload_.storage_.value, other.payload_.storage_.value);
+        } else if (payload_.has_value()) {
+            other.payload_.construct(std::move(payload_.storage_.value));
+            payload_.destroy();
+        } else if (other.payload_.has_value()) {
+            payload_.construct(std::move(other.payload_.storage_.value));
+            other.payload_.destroy();
         }
     }
 
     // Reset to empty state
     void reset() noexcept {
-        if (has_value_) {
-            storage_.value.~T();
-            has_value_ = false;
+        if (payload_.has_value()) {
+            payload_.destroy();
         }
     }
 
@@ -250,14 +499,161 @@ public:
     template <typename... Args>
     T& emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
         reset();
-        new (&storage_.value) T(std::forward<Args>(args)...);
-        has_value_ = true;
-        return storage_.value;
+        payload_.construct(std::forward<Args>(args)...);
+        return payload_.storage_.value;
     }
 
 private:
-    optional_storage<T> storage_;
-    bool has_value_;
+    template <typename U>
+    friend class optional;
+
+    // Constructs the value from f(args...), for transform()
+    template <typename F, typename... Args>
+    constexpr optional(optional_invoke_t tag, F&& f, Args&&... args)
+        : payload_(tag, std::forward<F>(f), std::forward<Args>(args)...) {}
+
+    // Self is optional (possibly const, lvalue or rvalue); the value is passed
+    // on with the same category
+    template <typename Self, typename F>
+    static constexpr auto and_then_impl(Self&& self, F&& f) {
+        using Result = std::remove_cv_t<std::remove_reference_t<
+            std::invoke_result_t<F, decltype((std::forward<Self>(self).payload_.storage_.value))>>>;
+        static_assert(is_optional_v<Result>, "and_then: the function must return an optional");
+        if (self.payload_.has_value()) {
+            return std::invoke(std::forward<F>(f), std::forward<Self>(self).payload_.storage_.value);
+        }
+        return Result();
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_impl(Self&& self, F&& f) {
+        using Result = std::remove_cv_t<
+            std::invoke_result_t<F, decltype((std::forward<Self>(self).payload_.storage_.value))>>;
+        static_assert(!std::is_rvalue_reference_v<Result> && !std::is_same_v<Result, in_place_t> &&
+                          !std::is_same_v<Result, nullopt_t>,
+                      "transform: the function must return an object type or an lvalue reference");
+        if (self.payload_.has_value()) {
+            if constexpr (std::is_lvalue_reference_v<Result>) {
+                return optional<Result>(
+                    std::invoke(std::forward<F>(f), std::forward<Self>(self).payload_.storage_.value));
+            } else {
+                return optional<Result>(optional_invoke, std::forward<F>(f),
+                                        std::forward<Self>(self).payload_.storage_.value);
+            }
+        }
+        return optional<Result>();
+    }
+
+    optional_payload_t<T> payload_;
+};
+
+// Specialization for references: an optional view of an object owned
+// elsewhere, held as a single pointer (null when empty). Copying copies the
+// pointer, and assignment rebinds rather than assigning through, so
+// optional<T&> is trivially copyable. It cannot be bound to a temporary.
+template <typename T>
+class optional<T&> {
+public:
+    using value_type = T&;
+
+    constexpr optional() noexcept = default;
+
+    constexpr optional(nullopt_t) noexcept {}
+
+    // Binds to ref
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr optional(U& ref) noexcept : ptr_(std::addressof(ref)) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    optional(const U&&) = delete;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr explicit optional(in_place_t, U& ref) noexcept : ptr_(std::addressof(ref)) {}
+
+    // From optional<U&>, binding to the same object
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr optional(const optional<U&>& other) noexcept : ptr_(other ? std::addressof(*other) : nullptr) {}
+
+    optional& operator=(nullopt_t) noexcept {
+        ptr_ = nullptr;
+        return *this;
+    }
+
+    // Observers. Constness is shallow, as for a pointer: a const optional<T&>
+    // still gives access to a T&.
+    constexpr T* operator->() const noexcept { return ptr_; }
+
+    constexpr T& operator*() const noexcept { return *ptr_; }
+
+    constexpr explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    constexpr bool has_value() const noexcept { return ptr_ != nullptr; }
+
+    constexpr T& value() const {
+        if (!ptr_) {
+            throw bad_optional_access();
+        }
+        return *ptr_;
+    }
+
+    // A copy of the referenced object, or the default
+    template <typename U>
+    constexpr std::remove_cv_t<T> value_or(U&& default_value) const {
+        return ptr_ ? *ptr_ : static_cast<std::remove_cv_t<T>>(std::forward<U>(default_value));
+    }
+
+    template <typename F>
+    constexpr std::remove_cv_t<T> value_or_else(F&& f) const {
+        return ptr_ ? *ptr_ : static_cast<std::remove_cv_t<T>>(std::invoke(std::forward<F>(f)));
+    }
+
+    // Monadic operations; the function always receives a T&
+    template <typename F>
+    constexpr auto and_then(F&& f) const {
+        using Result = std::remove_cv_t<std::remove_reference_t<std::invoke_result_t<F, T&>>>;
+        static_assert(is_optional_v<Result>, "and_then: the function must return an optional");
+        if (ptr_) {
+            return std::invoke(std::forward<F>(f), *ptr_);
+        }
+        return Result();
+    }
+
+    template <typename F>
+    constexpr auto transform(F&& f) const {
+        using Result = std::remove_cv_t<std::invoke_result_t<F, T&>>;
+        static_assert(!std::is_rvalue_reference_v<Result> && !std::is_same_v<Result, in_place_t> &&
+                          !std::is_same_v<Result, nullopt_t>,
+                      "transform: the function must return an object type or an lvalue reference");
+        if (ptr_) {
+            if constexpr (std::is_lvalue_reference_v<Result>) {
+                return optional<Result>(std::invoke(std::forward<F>(f), *ptr_));
+            } else {
+                return optional<Result>(optional_invoke, std::forward<F>(f), *ptr_);
+            }
+        }
+        return optional<Result>();
+    }
+
+    template <typename F>
+    constexpr optional or_else(F&& f) const {
+        static_assert(std::is_same_v<std::decay_t<std::invoke_result_t<F>>, optional>,
+                      "or_else: the function must return optional<T&>");
+        return ptr_ ? *this : std::invoke(std::forward<F>(f));
+    }
+
+    void swap(optional& other) noexcept { std::swap(ptr_, other.ptr_); }
+
+    void reset() noexcept { ptr_ = nullptr; }
+
+    // Rebinds to ref
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    T& emplace(U& ref) noexcept {
+        ptr_ = std::addressof(ref);
+        return *ptr_;
+    }
+
+private:
+    T* ptr_ = nullptr;
 };
 
 // Comparison operators
@@ -322,24 +718,25 @@ constexpr bool operator!=(nullopt_t, const optional<T>& opt) noexcept {
     return opt.has_value();
 }
 
-// Comparison with value
+// Comparison with value. The value's type is not deduced, so it may be
+// anything convertible to T, and optional<T&> compares with a plain T.
 template <typename T>
-constexpr bool operator==(const optional<T>& opt, const T& value) {
+constexpr bool operator==(const optional<T>& opt, const std::remove_reference_t<T>& value) {
     return opt.has_value() && *opt == value;
 }
 
 template <typename T>
-constexpr bool operator==(const T& value, const optional<T>& opt) {
+constexpr bool operator==(const std::remove_reference_t<T>& value, const optional<T>& opt) {
     return opt.has_value() && value == *opt;
 }
 
 template <typename T>
-constexpr bool operator!=(const optional<T>& opt, const T& value) {
+constexpr bool operator!=(const optional<T>& opt, const std::remove_reference_t<T>& value) {
     return !opt.has_value() || *opt != value;
 }
 
 template <typename T>
-constexpr bool operator!=(const T& value, const optional<T>& opt) {
+constexpr bool operator!=(const std::remove_reference_t<T>& value, const optional<T>& opt) {
     return !opt.has_value() || value != *opt;
 }
 
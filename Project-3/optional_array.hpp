@@ -0,0 +1,275 @@
+#ifndef OPTIONAL_ARRAY_HPP
+#define OPTIONAL_ARRAY_HPP
+
+#include "optional.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// A column of optional values stored as two dense arrays: the values
+// themselves, and a bitmap with one presence bit per element.
+//
+// Compared with std::vector<optional<T>>, no space goes to per-element
+// flags and padding (an optional<double> is 16 bytes, here an element costs
+// 8 bytes and one bit), and the values are contiguous, so the bulk
+// operations below run over plain T[] and 64-bit words that the compiler can
+// vectorize. Missing elements always hold T(), which lets sum_present() add
+// every slot without looking at the bitmap.
+//
+// T must be trivially copyable and default constructible: this is a column
+// of plain values such as readings or indices, not a general container.
+template <typename T>
+class optional_array {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+                  "optional_array requires a trivially copyable, default constructible T");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // optional-like view of one element; assigning to it sets or clears
+    // the element
+    class reference {
+    public:
+        reference& operator=(const T& value) {
+            array_->set(index_, value);
+            return *this;
+        }
+
+        reference& operator=(nullopt_t) {
+            array_->reset(index_);
+            return *this;
+        }
+
+        reference& operator=(const optional<T>& value) {
+            if (value) {
+                array_->set(index_, *value);
+            } else {
+                array_->reset(index_);
+            }
+            return *this;
+        }
+
+        // Assigns the other element's state, not the reference itself
+        reference& operator=(const reference& other) { return *this = optional<T>(other); }
+
+        bool has_value() const noexcept { return array_->has_value(index_); }
+
+        explicit operator bool() const noexcept { return has_value(); }
+
+        const T& operator*() const noexcept { return array_->values_[index_]; }
+
+        const T* operator->() const noexcept { return &array_->values_[index_]; }
+
+        const T& value() const {
+            if (!has_value()) {
+                throw bad_optional_access();
+            }
+            return **this;
+        }
+
+        template <typename U>
+        T value_or(U&& default_value) const {
+            return has_value() ? **this : static_cast<T>(std::forward<U>(default_value));
+        }
+
+        void reset() noexcept { array_->reset(index_); }
+
+        operator optional<T>() const { return has_value() ? optional<T>(**this) : optional<T>(); }
+
+    private:
+        friend class optional_array;
+
+        reference(optional_array* array, size_type index) noexcept : array_(array), index_(index) {}
+
+        optional_array* array_;
+        size_type index_;
+    };
+
+    optional_array() = default;
+
+    // count missing elements
+    explicit optional_array(size_type count) { resize(count); }
+
+    optional_array(std::initializer_list<optional<T>> init) {
+        reserve(init.size());
+        for (const optional<T>& value : init) {
+            push_back(value);
+        }
+    }
+
+    size_type size() const noexcept { return values_.size(); }
+
+    bool empty() const noexcept { return values_.empty(); }
+
+    void reserve(size_type count) {
+        values_.reserve(count);
+        present_.reserve(word_count(count));
+    }
+
+    // New elements are missing
+    void resize(size_type count) {
+        values_.resize(count, T());
+        present_.resize(word_count(count), 0);
+        clear_tail();
+    }
+
+    void clear() noexcept {
+        values_.clear();
+        present_.clear();
+    }
+
+    void push_back(const T& value) {
+        grow_one();
+        values_.push_back(value);
+        set_bit(values_.size() - 1);
+    }
+
+    void push_back(nullopt_t) {
+        grow_one();
+        values_.push_back(T());
+    }
+
+    void push_back(const optional<T>& value) {
+        if (value) {
+            push_back(*value);
+        } else {
+            push_back(nullopt);
+        }
+    }
+
+    // Element access, unchecked
+    reference operator[](size_type i) noexcept { return reference(this, i); }
+
+    optional<const T&> operator[](size_type i) const noexcept {
+        return has_value(i) ? optional<const T&>(values_[i]) : optional<const T&>();
+    }
+
+    // Element access, throwing std::out_of_range past the end
+    reference at(size_type i) {
+        check_index(i);
+        return (*this)[i];
+    }
+
+    optional<const T&> at(size_type i) const {
+        check_index(i);
+        return (*this)[i];
+    }
+
+    bool has_value(size_type i) const noexcept { return (present_[i / word_bits] >> (i % word_bits)) & 1; }
+
+    void set(size_type i, const T& value) noexcept {
+        values_[i] = value;
+        set_bit(i);
+    }
+
+    void reset(size_type i) noexcept {
+        values_[i] = T();
+        present_[i / word_bits] &= ~(word_type(1) << (i % word_bits));
+    }
+
+    // The dense values, T() where missing, and the presence bitmap: bit
+    // i % 64 of word i / 64 is set when element i is present
+    const T* values() const noexcept { return values_.data(); }
+
+    const std::uint64_t* presence() const noexcept { return present_.data(); }
+
+    // Bulk operations
+
+    size_type count_present() const noexcept {
+        size_type count = 0;
+        for (word_type word : present_) {
+            count += popcount(word);
+        }
+        return count;
+    }
+
+    size_type count_missing() const noexcept { return size() - count_present(); }
+
+    // Sets every missing element to value; afterwards all are present
+    void fill_missing(const T& value) noexcept {
+        const size_type n = size();
+        T* data = values_.data();
+        for (size_type w = 0; w < present_.size(); ++w) {
+            const word_type word = present_[w];
+            const size_type base = w * word_bits;
+            const size_type end = base + word_bits < n ? base + word_bits : n;
+            if (word != ~word_type(0)) {
+                // A select per element, with no branch on the bit
+                for (size_type i = base; i < end; ++i) {
+                    data[i] = ((word >> (i - base)) & 1) ? data[i] : value;
+                }
+            }
+            present_[w] = end - base == word_bits ? ~word_type(0) : (word_type(1) << (end - base)) - 1;
+        }
+    }
+
+    // Sum of the present elements. Missing elements hold T(), so this adds
+    // every slot; four independent partial sums keep the adds pipelined and
+    // vectorizable. For floating-point T the result can round differently
+    // from a left-to-right loop.
+    T sum_present() const noexcept {
+        const size_type n = size();
+        const T* data = values_.data();
+        T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+        size_type i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 += data[i];
+            s1 += data[i + 1];
+            s2 += data[i + 2];
+            s3 += data[i + 3];
+        }
+        for (; i < n; ++i) {
+            s0 += data[i];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+
+private:
+    using word_type = std::uint64_t;
+    static constexpr size_type word_bits = 64;
+
+    static size_type word_count(size_type count) noexcept { return (count + word_bits - 1) / word_bits; }
+
+    static size_type popcount(word_type word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_type>(__builtin_popcountll(word));
+#else
+        size_type count = 0;
+        for (; word != 0; word &= word - 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    void check_index(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range("optional_array: index out of range");
+        }
+    }
+
+    void grow_one() {
+        if (values_.size() % word_bits == 0) {
+            present_.push_back(0);
+        }
+    }
+
+    void set_bit(size_type i) noexcept { present_[i / word_bits] |= word_type(1) << (i % word_bits); }
+
+    // Keeps the bits past size() clear after shrinking
+    void clear_tail() noexcept {
+        const size_type used = values_.size() % word_bits;
+        if (used != 0) {
+            present_.back() &= (word_type(1) << used) - 1;
+        }
+    }
+
+    std::vector<T> values_;
+    std::vector<word_type> present_;
+};
+
+#endif // OPTIONAL_ARRAY_HPP
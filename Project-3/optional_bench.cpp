@@ -0,0 +1,346 @@
+// Micro-benchmark: optional<T> against std::optional<T> for trivially
+// copyable T, where both should compile to the same plain loads and stores.
+//
+// Usage: optional_bench [elements] [repetitions]
+//
+// Measures vector growth by emplace_back (reallocation relocates the elements),
+// copying a whole vector, assigning element by element, and reading values
+// back with value_or. A second table probes a lookup table of pointers at
+// random, where the niche makes optional<const double*> half the size of
+// std::optional<const double*>. Both sides must compute the same checksums or
+// the benchmark fails.
+//
+// The last table runs a five-stage lookup pipeline over a 256-byte record,
+// once chained with and_then / transform / value_or_else and once written
+// out as nested ifs over the same stage functions, and counts the copies and
+// moves of the record each makes. The chain must make no copies, and no more
+// moves than the nested ifs.
+//
+// Finally the column operations of optional_array<double> are timed against
+// the same loops over std::vector<optional<double>>.
+
+#include "optional.hpp"
+#include "optional_array.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F>
+double best_seconds(std::size_t repetitions, F&& run) {
+    double best = 0;
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        const Clock::time_point start = Clock::now();
+        run();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (r == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+volatile std::uint64_t sink;
+
+// One element in four is empty.
+template <typename Opt>
+void append_element(std::vector<Opt>& v, std::size_t i) {
+    if (i % 4 == 3) {
+        v.emplace_back();
+    } else {
+        v.emplace_back(double(i));
+    }
+}
+
+template <typename Opt>
+std::uint64_t checksum(const std::vector<Opt>& v) {
+    std::uint64_t sum = 0;
+    for (const Opt& o : v) sum += static_cast<std::uint64_t>(o.value_or(1.0));
+    return sum;
+}
+
+struct result {
+    double grow, copy, assign, read;
+    std::uint64_t sum;
+};
+
+template <typename Opt>
+result run(std::size_t count, std::size_t repetitions) {
+    result r{};
+    std::vector<Opt> source;
+    r.grow = best_seconds(repetitions, [&] {
+        std::vector<Opt> v;
+        for (std::size_t i = 0; i < count; ++i) append_element(v, i);
+        source.swap(v);
+    });
+    r.copy = best_seconds(repetitions, [&] {
+        std::vector<Opt> v(source);
+        sink = v.size();
+    });
+    std::vector<Opt> target(count);
+    r.assign = best_seconds(repetitions, [&] {
+        for (std::size_t i = 0; i < count; ++i) target[i] = source[count - 1 - i];
+        sink = target.size();
+    });
+    r.read = best_seconds(repetitions, [&] { sink = checksum(target); });
+    r.sum = checksum(target);
+    return r;
+}
+
+// A table of four entries per element, every other one empty, probed at
+// random indices.
+template <typename Opt>
+double lookup(const std::vector<double>& values, std::size_t repetitions, std::uint64_t& sum) {
+    const std::size_t size = values.size() * 4;
+    std::vector<Opt> table(size);
+    for (std::size_t i = 0; i < size; i += 2) table[i] = &values[i / 4];
+    std::uint64_t total = 0;
+    const double seconds = best_seconds(repetitions, [&] {
+        std::uint64_t state = 0x9e3779b97f4a7c15ull, h = 0;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            const Opt& entry = table[state % size];
+            if (entry) h += static_cast<std::uint64_t>(**entry);
+        }
+        total = h;
+    });
+    sum = total;
+    return seconds;
+}
+
+// A large record that counts how often it is copied or moved.
+struct record {
+    static std::uint64_t copies;
+    static std::uint64_t moves;
+
+    std::uint64_t key;
+    unsigned char data[248];
+
+    explicit record(std::uint64_t k) : key(k) { std::memset(data, static_cast<int>(k & 0xff), sizeof data); }
+    record(const record& other) : key(other.key) {
+        std::memcpy(data, other.data, sizeof data);
+        ++copies;
+    }
+    record(record&& other) noexcept : key(other.key) {
+        std::memcpy(data, other.data, sizeof data);
+        ++moves;
+    }
+    record& operator=(const record&) = delete;
+    record& operator=(record&&) = delete;
+};
+
+std::uint64_t record::copies = 0;
+std::uint64_t record::moves = 0;
+
+// The pipeline's stages. Some keys drop out at each of the first three.
+optional<record> find_record(std::uint64_t key) {
+    if (key % 8 == 7) return nullopt;
+    return optional<record>(in_place, key);
+}
+
+optional<record> check_record(record&& r) {
+    if (r.key % 5 == 4) return nullopt;
+    return optional<record>(std::move(r));
+}
+
+record stamp_record(record&& r) {
+    r.data[0] ^= 0x5a;
+    return std::move(r);
+}
+
+optional<record> check_stamp(record&& r) {
+    if (r.data[0] == 0) return nullopt;
+    return optional<record>(std::move(r));
+}
+
+std::uint64_t digest(const record& r) { return r.key + r.data[0] + r.data[247]; }
+
+std::uint64_t chained(std::uint64_t key) {
+    return find_record(key)
+        .and_then(check_record)
+        .transform(stamp_record)
+        .and_then(check_stamp)
+        .transform(digest)
+        .value_or_else([] { return std::uint64_t(0); });
+}
+
+std::uint64_t nested(std::uint64_t key) {
+    optional<record> found = find_record(key);
+    if (found) {
+        optional<record> checked = check_record(std::move(*found));
+        if (checked) {
+            optional<record> stamped(stamp_record(std::move(*checked)));
+            optional<record> ok = check_stamp(std::move(*stamped));
+            if (ok) {
+                return digest(*ok);
+            }
+        }
+    }
+    return 0;
+}
+
+struct pipeline_result {
+    double seconds;
+    std::uint64_t copies, moves, sum;
+};
+
+template <typename F>
+pipeline_result pipeline(F&& run_one, std::size_t count, std::size_t repetitions) {
+    pipeline_result r{};
+    record::copies = 0;
+    record::moves = 0;
+    for (std::uint64_t key = 0; key < count; ++key) r.sum += run_one(key);
+    r.copies = record::copies;
+    r.moves = record::moves;
+    r.seconds = best_seconds(repetitions, [&] {
+        std::uint64_t h = 0;
+        for (std::uint64_t key = 0; key < count; ++key) h += run_one(key);
+        sink = h;
+    });
+    return r;
+}
+
+struct column_result {
+    double count, sum, fill;
+    std::uint64_t checksum;
+};
+
+// One reading in three is missing.
+column_result column_vector(std::size_t count, std::size_t repetitions) {
+    std::vector<optional<double>> base(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 3 != 1) base[i] = double(i % 1000);
+    }
+    column_result r{};
+    std::size_t present = 0;
+    double sum = 0;
+    r.count = best_seconds(repetitions, [&] {
+        present = 0;
+        for (const optional<double>& o : base) present += o.has_value();
+        sink = present;
+    });
+    r.sum = best_seconds(repetitions, [&] {
+        sum = 0;
+        for (const optional<double>& o : base) {
+            if (o) sum += *o;
+        }
+        sink = static_cast<std::uint64_t>(sum);
+    });
+    std::vector<optional<double>> column;
+    r.fill = best_seconds(repetitions, [&] {
+        column = base;
+        for (optional<double>& o : column) {
+            if (!o) o = -1.0;
+        }
+        sink = column.size();
+    });
+    r.checksum = present + static_cast<std::uint64_t>(sum) + static_cast<std::uint64_t>(*column[1] + 1.0);
+    return r;
+}
+
+column_result column_array(std::size_t count, std::size_t repetitions) {
+    optional_array<double> base(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 3 != 1) base.set(i, double(i % 1000));
+    }
+    column_result r{};
+    std::size_t present = 0;
+    double sum = 0;
+    r.count = best_seconds(repetitions, [&] {
+        present = base.count_present();
+        sink = present;
+    });
+    r.sum = best_seconds(repetitions, [&] {
+        sum = base.sum_present();
+        sink = static_cast<std::uint64_t>(sum);
+    });
+    optional_array<double> column;
+    r.fill = best_seconds(repetitions, [&] {
+        column = base;
+        column.fill_missing(-1.0);
+        sink = column.size();
+    });
+    r.checksum = present + static_cast<std::uint64_t>(sum) + static_cast<std::uint64_t>(*column[1] + 1.0);
+    return r;
+}
+
+void print_row(const char* name, double mine, double std_seconds, std::size_t count) {
+    std::cout << std::setw(10) << name << std::fixed << std::setprecision(2) << std::setw(14)
+              << mine * 1e9 / double(count) << std::setw(18) << std_seconds * 1e9 / double(count) << '\n';
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    if (count == 0 || repetitions == 0) {
+        std::cerr << "usage: optional_bench [elements] [repetitions]\n";
+        return 1;
+    }
+    static_assert(std::is_trivially_copyable_v<optional<double>>);
+    static_assert(sizeof(optional<double>) == sizeof(std::optional<double>));
+
+    const result mine = run<optional<double>>(count, repetitions);
+    const result theirs = run<std::optional<double>>(count, repetitions);
+
+    std::cout << "optional<double>, " << count << " elements (ns/element)\n"
+              << std::setw(10) << "" << std::setw(14) << "optional" << std::setw(18) << "std::optional" << '\n';
+    print_row("emplace", mine.grow, theirs.grow, count);
+    print_row("copy", mine.copy, theirs.copy, count);
+    print_row("assign", mine.assign, theirs.assign, count);
+    print_row("value_or", mine.read, theirs.read, count);
+
+    std::vector<double> values(count);
+    for (std::size_t i = 0; i < count; ++i) values[i] = double(i);
+    std::uint64_t mine_lookup_sum = 0, theirs_lookup_sum = 0;
+    const double mine_lookup = lookup<optional<const double*>>(values, repetitions, mine_lookup_sum);
+    const double theirs_lookup = lookup<std::optional<const double*>>(values, repetitions, theirs_lookup_sum);
+    std::cout << "\noptional<const double*> table, " << count * 4 << " entries (ns/lookup)\n"
+              << std::setw(10) << "" << std::setw(14) << "optional" << std::setw(18) << "std::optional" << '\n'
+              << std::setw(10) << "bytes" << std::setw(14) << sizeof(optional<const double*>) << std::setw(18)
+              << sizeof(std::optional<const double*>) << '\n';
+    print_row("lookup", mine_lookup, theirs_lookup, count);
+
+    const pipeline_result chain = pipeline(chained, count, repetitions);
+    const pipeline_result ifs = pipeline(nested, count, repetitions);
+    std::cout << "\n5-stage pipeline over a " << sizeof(record) << "-byte record, " << count << " keys\n"
+              << std::setw(10) << "" << std::setw(14) << "chained" << std::setw(18) << "nested ifs" << '\n';
+    print_row("ns/key", chain.seconds, ifs.seconds, count);
+    std::cout << std::setw(10) << "copies" << std::setw(14) << chain.copies << std::setw(18) << ifs.copies << '\n'
+              << std::setw(10) << "moves" << std::setw(14) << chain.moves << std::setw(18) << ifs.moves << '\n';
+    if (chain.sum != ifs.sum || chain.copies != 0 || chain.moves > ifs.moves) {
+        std::cerr << "pipeline: checksums " << chain.sum << " vs " << ifs.sum << ", " << chain.copies << " copies, "
+                  << chain.moves << " vs " << ifs.moves << " moves\n";
+        return 1;
+    }
+
+    const column_result dense = column_array(count, repetitions);
+    const column_result sparse = column_vector(count, repetitions);
+    std::cout << "\ncolumn of " << count << " readings, one in three missing (ns/element)\n"
+              << std::setw(10) << "" << std::setw(14) << "optional_array" << std::setw(18) << "vector<optional>" << '\n'
+              << std::setw(10) << "bits" << std::setw(14) << sizeof(double) * 8 + 1 << std::setw(18)
+              << sizeof(optional<double>) * 8 << '\n';
+    print_row("count", dense.count, sparse.count, count);
+    print_row("sum", dense.sum, sparse.sum, count);
+    print_row("fill", dense.fill, sparse.fill, count);
+    if (dense.checksum != sparse.checksum) {
+        std::cerr << "column: checksums differ: " << dense.checksum << " vs " << sparse.checksum << '\n';
+        return 1;
+    }
+
+    if (mine.sum != theirs.sum || mine_lookup_sum != theirs_lookup_sum) {
+        std::cerr << "checksums differ: " << mine.sum << " vs " << theirs.sum << ", " << mine_lookup_sum << " vs "
+                  << theirs_lookup_sum << '\n';
+        return 1;
+    }
+    return 0;
+}
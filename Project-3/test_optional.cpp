@@ -1,8 +1,53 @@
 #include "optional.hpp"
+#include "optional_array.hpp"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+// An index type that reserves its largest value to mean "no slot".
+enum class slot : std::uint32_t { none = 0xffffffff };
+
+template <>
+struct optional_niche<slot> : optional_niche_value<slot, slot::none> {};
+
+// Counts the copies and moves made of it.
+struct Tracked {
+    static int copies;
+    static int moves;
+    int value;
+    explicit Tracked(int v) : value(v) {}
+    Tracked(const Tracked& other) : value(other.value) { ++copies; }
+    Tracked(Tracked&& other) noexcept : value(other.value) { ++moves; }
+    Tracked& operator=(const Tracked& other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    Tracked& operator=(Tracked&& other) noexcept {
+        value = other.value;
+        ++moves;
+        return *this;
+    }
+};
+
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+optional<int> parse_digit(char c) {
+    if (c < '0' || c > '9') return nullopt;
+    return c - '0';
+}
+
+// A cache lookup that hands out a view of the entry instead of a copy.
+optional<const Tracked&> find_entry(const std::vector<Tracked>& cache, int key) {
+    for (const Tracked& entry : cache) {
+        if (entry.value == key) return entry;
+    }
+    return nullopt;
+}
 
 void print_separator(const std::string& title) {
     std::cout << "\n=== " << title << " ===\n";
@@ -219,6 +264,207 @@ int main() {
     std::cout << "✓ Type conversion works\n";
     std::cout << "✓ int: " << opt34.value() << ", double: " << opt35.value() << "\n";
 
+    // Test 25: Trivially copyable storage
+    print_separator("Test 25: Trivially Copyable Storage");
+    static_assert(std::is_trivially_copyable_v<optional<int>>);
+    static_assert(std::is_trivially_copyable_v<optional<double>>);
+    static_assert(std::is_trivially_destructible_v<optional<int>>);
+    static_assert(std::is_trivially_copy_constructible_v<optional<int>>);
+    static_assert(std::is_trivially_move_assignable_v<optional<int>>);
+    static_assert(!std::is_trivially_copyable_v<optional<std::string>>);
+    static_assert(!std::is_trivially_destructible_v<optional<std::string>>);
+    static_assert(std::is_nothrow_move_constructible_v<optional<std::string>>);
+    static_assert(sizeof(optional<int>) == 2 * sizeof(int));
+    std::vector<optional<int>> opts;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3 == 0) {
+            opts.push_back(nullopt);
+        } else {
+            opts.push_back(i);
+        }
+    }
+    std::vector<optional<int>> opts_copy = opts;
+    for (int i = 0; i < 1000; ++i) {
+        assert(opts_copy[i].has_value() == (i % 3 != 0));
+        assert(opts_copy[i].value_or(-1) == (i % 3 == 0 ? -1 : i));
+    }
+    optional<int> opt36(5);
+    optional<int> opt37;
+    opt36 = opt37;
+    assert(!opt36.has_value());
+    opt37 = optional<int>(6);
+    assert(*opt37 == 6);
+    std::cout << "✓ optional<int> is trivially copyable and survives vector growth\n";
+    std::cout << "✓ Trivial copy from Test 4 holds: " << *opt4 << "\n";
+
+    // Test 26: Conversion from optional<U>
+    print_separator("Test 26: Conversion from optional<U>");
+    optional<const char*> opt38("converted");
+    optional<std::string> opt39(opt38);
+    assert(opt39.has_value() && *opt39 == "converted");
+    optional<const char*> opt40;
+    optional<std::string> opt41(opt40);
+    assert(!opt41.has_value());
+    optional<double> opt42(opt34);
+    assert(*opt42 == 10.0);
+    std::cout << "✓ optional<std::string> constructed from optional<const char*>\n";
+    std::cout << "✓ Value: " << *opt39 << "\n";
+
+    // Test 27: Niche optimization
+    print_separator("Test 27: Niche Optimization");
+    static_assert(sizeof(optional<int*>) == sizeof(int*));
+    static_assert(sizeof(optional<const char*>) == sizeof(const char*));
+    static_assert(sizeof(optional<slot>) == sizeof(std::uint32_t));
+    static_assert(sizeof(optional<std::uint32_t>) == 2 * sizeof(std::uint32_t));
+    static_assert(std::is_trivially_copyable_v<optional<int*>>);
+    int target = 7;
+    optional<int*> opt43;
+    assert(!opt43.has_value());
+    opt43 = &target;
+    assert(opt43.has_value() && **opt43 == 7);
+    optional<int*> opt44(nullptr);
+    assert(opt44.has_value() && *opt44 == nullptr);
+    opt43.swap(opt44);
+    assert(*opt43 == nullptr && *opt44 == &target);
+    opt44.reset();
+    assert(!opt44.has_value() && opt44 == nullopt);
+    std::vector<optional<slot>> slots(8);
+    slots[3] = slot{3};
+    slots[5].emplace(slot{5});
+    std::vector<optional<slot>> slots_copy = slots;
+    for (std::size_t i = 0; i < slots_copy.size(); ++i) {
+        assert(slots_copy[i].has_value() == (i == 3 || i == 5));
+    }
+    assert(slots_copy[5].value() == slot{5});
+    assert(slots_copy[0].value_or(slot{9}) == slot{9});
+    std::cout << "✓ optional<T*> is " << sizeof(optional<int*>) << " bytes, optional<slot> is "
+              << sizeof(optional<slot>) << " bytes\n";
+
+    // Test 28: Monadic operations
+    print_separator("Test 28: and_then / transform / or_else / value_or_else");
+    optional<char> opt45('7');
+    optional<char> opt46('x');
+    assert(opt45.and_then(parse_digit) == 7);
+    assert(!opt46.and_then(parse_digit).has_value());
+    assert(!optional<char>().and_then(parse_digit).has_value());
+    optional<std::string> opt47 = opt45.and_then(parse_digit).transform([](int d) { return std::string(d, '*'); });
+    assert(*opt47 == "*******");
+    assert(!opt46.and_then(parse_digit).transform([](int d) { return d * 2; }).has_value());
+    assert(opt46.and_then(parse_digit).or_else([] { return optional<int>(-1); }) == -1);
+    assert(opt45.and_then(parse_digit).or_else([] { return optional<int>(-1); }) == 7);
+    int fallback_calls = 0;
+    auto fallback = [&fallback_calls] {
+        ++fallback_calls;
+        return std::string("fallback");
+    };
+    const std::string present = opt47.value_or_else(fallback);
+    assert(present == "*******" && fallback_calls == 0);
+    const std::string absent = optional<std::string>().value_or_else(fallback);
+    assert(absent == "fallback" && fallback_calls == 1);
+    const optional<int> opt48(4);
+    assert(opt48.transform([](const int& v) { return v + 1; }) == 5);
+    std::cout << "✓ and_then, transform, or_else and value_or_else work\n";
+    std::cout << "✓ value_or_else: " << present << ", " << absent << " (" << fallback_calls << " fallback call)\n";
+
+    // Test 29: Rvalue chains move instead of copying
+    print_separator("Test 29: Rvalue Chains Move");
+    Tracked::copies = 0;
+    Tracked::moves = 0;
+    optional<Tracked> opt49 = optional<Tracked>(in_place, 1)
+                                  .and_then([](Tracked&& t) {
+                                      t.value += 1;
+                                      return optional<Tracked>(std::move(t));
+                                  })
+                                  .transform([](Tracked&& t) { return Tracked(t.value * 10); })
+                                  .or_else([] { return optional<Tracked>(in_place, 0); });
+    assert(opt49->value == 20);
+    assert(Tracked::copies == 0);
+    assert(Tracked::moves == 2); // into and_then's result, then out of or_else
+    Tracked::moves = 0;
+    Tracked opt50 = std::move(opt49).value_or_else([] { return Tracked(0); });
+    assert(opt50.value == 20);
+    assert(Tracked::copies == 0 && Tracked::moves == 1);
+    std::cout << "✓ No copies along an rvalue chain\n";
+    std::cout << "✓ Value: " << opt50.value << "\n";
+
+    // Test 30: Reference specialization
+    print_separator("Test 30: optional<T&>");
+    static_assert(sizeof(optional<std::string&>) == sizeof(std::string*));
+    static_assert(std::is_trivially_copyable_v<optional<std::string&>>);
+    static_assert(!std::is_constructible_v<optional<const std::string&>, std::string&&>);
+    std::vector<Tracked> cache;
+    cache.reserve(3);
+    for (int key = 1; key <= 3; ++key) cache.emplace_back(key * 100);
+    Tracked::copies = 0;
+    Tracked::moves = 0;
+    optional<const Tracked&> hit = find_entry(cache, 200);
+    assert(hit.has_value() && &*hit == &cache[1] && hit->value == 200);
+    assert(!find_entry(cache, 250).has_value());
+    assert(hit.transform([](const Tracked& t) { return t.value + 1; }) == 201);
+    assert(Tracked::copies == 0 && Tracked::moves == 0);
+    std::string first = "first";
+    std::string second = "second";
+    optional<std::string&> opt51(first);
+    opt51->append("!");
+    assert(first == "first!");
+    opt51 = second; // rebinds; first is untouched
+    *opt51 = "changed";
+    assert(first == "first!" && second == "changed");
+    assert(opt51 == second && opt51 != first);
+    optional<std::string&> opt52;
+    assert(opt52.value_or("none") == "none");
+    try {
+        opt52.value();
+        assert(false); // Should not reach here
+    } catch (const bad_optional_access&) {
+    }
+    opt52.swap(opt51);
+    assert(!opt51.has_value() && &opt52.value() == &second);
+    std::cout << "✓ optional<T&> is " << sizeof(optional<std::string&>) << " bytes and rebinds on assignment\n";
+    std::cout << "✓ Cache hit: " << hit->value << " with " << Tracked::copies << " copies\n";
+
+    // Test 31: optional_array
+    print_separator("Test 31: optional_array");
+    optional_array<double> readings{1.5, nullopt, 2.5, nullopt, 4.0};
+    assert(readings.size() == 5);
+    assert(readings.count_present() == 3 && readings.count_missing() == 2);
+    assert(readings.sum_present() == 8.0);
+    assert(readings[0].has_value() && *readings[0] == 1.5);
+    assert(!readings[1].has_value() && readings[1].value_or(-1.0) == -1.0);
+    readings[1] = 3.0;
+    readings[2] = nullopt;
+    assert(readings[1].value() == 3.0 && !readings[2]);
+    const optional_array<double>& creadings = readings;
+    optional<const double&> cview = creadings[1];
+    assert(cview && &*cview == &creadings.values()[1]);
+    optional<double> copied = readings[4];
+    assert(copied == 4.0);
+    readings[3] = readings[4];
+    assert(*readings[3] == 4.0);
+    try {
+        creadings.at(5);
+        assert(false); // Should not reach here
+    } catch (const std::out_of_range&) {
+    }
+    optional_array<double> column(200);
+    for (std::size_t i = 0; i < column.size(); i += 3) column.set(i, double(i));
+    assert(column.count_present() == 67);
+    double expected = 0;
+    for (std::size_t i = 0; i < 200; i += 3) expected += double(i);
+    assert(column.sum_present() == expected);
+    column.fill_missing(-1.0);
+    assert(column.count_present() == 200);
+    assert(*column[1] == -1.0 && *column[3] == 3.0 && *column[199] == -1.0);
+    column.resize(70);
+    column.resize(130);
+    assert(column.count_present() == 70 && !column[100].has_value());
+    column.push_back(nullopt);
+    column.push_back(7.0);
+    assert(column.size() == 132 && column.count_present() == 71 && *column[131] == 7.0);
+    std::cout << "✓ optional_array stores " << readings.size() << " readings, " << readings.count_present()
+              << " present, sum " << readings.sum_present() << "\n";
+    std::cout << "✓ Views: readings[1] = " << *cview << ", readings[4] = " << *copied << "\n";
+
     print_separator("All Tests Passed!");
     std::cout << "\n✓ The optional<T> implementation is complete and working correctly!\n\n";
 
@@ -1,46 +1,14 @@
 #include "any.hpp"
+#include "any_collection.hpp"
+#include "config_manager.hpp"
 #include <iostream>
 #include <vector>
 #include <map>
 #include <string>
 #include <functional>
 
-// Example 1: Configuration system using any
-class ConfigManager {
-private:
-    std::map<std::string, my_std::any> config;
-
-public:
-    template<typename T>
-    void set(const std::string& key, T&& value) {
-        config[key] = std::forward<T>(value);
-    }
-
-    template<typename T>
-    T get(const std::string& key) {
-        auto it = config.find(key);
-        if (it == config.end()) {
-            throw std::runtime_error("Key not found: " + key);
-        }
-        return my_std::any_cast<T>(it->second);
-    }
-
-    template<typename T>
-    T get_or_default(const std::string& key, const T& default_value) {
-        auto it = config.find(key);
-        if (it == config.end() || it->second.type() != typeid(T)) {
-            return default_value;
-        }
-        return my_std::any_cast<T>(it->second);
-    }
-
-    void print_all() const {
-        std::cout << "Configuration:\n";
-        for (const auto& [key, value] : config) {
-            std::cout << "  " << key << ": " << value.type().name() << "\n";
-        }
-    }
-};
+// Example 1: Configuration system using any, in config_manager.hpp
+using my_std::ConfigManager;
 
 // Example 2: Variant-like behavior with any
 class Event {
@@ -51,30 +19,33 @@ public:
     Event(const std::string& n) : name(n) {}
 };
 
-// Example 3: Polymorphic container
+// Example 3: Polymorphic container, with the items grouped by type
 class PolymorphicContainer {
 private:
-    std::vector<my_std::any> items;
+    my_std::any_collection items;
 
 public:
-    void add(const my_std::any& item) {
-        items.push_back(item);
+    template<typename T>
+    void add(T&& item) {
+        items.push_back(std::forward<T>(item));
     }
 
     size_t size() const { return items.size(); }
 
     template<typename T>
     T* get(size_t index) {
-        if (index >= items.size()) {
-            return nullptr;
-        }
-        return my_std::any_cast<T>(&items[index]);
+        return items.get<T>(index);
+    }
+
+    template<typename T, typename F>
+    void for_each(F&& f) const {
+        items.for_each<T>(std::forward<F>(f));
     }
 
     void print_types() const {
         std::cout << "Container types: ";
-        for (const auto& item : items) {
-            std::cout << item.type().name() << " ";
+        for (size_t i = 0; i < items.size(); ++i) {
+            std::cout << items.type(i).name() << " ";
         }
         std::cout << "\n";
     }
@@ -102,6 +73,11 @@ int main() {
                   << cfg.get<bool>("debug_mode") << "\n";
         std::cout << "  timeout (default): " 
                   << cfg.get_or_default<int>("timeout", 30) << "\n";
+
+        // Typed keys hash at compile time; a resolved handle skips the lookup
+        static constexpr my_std::config_key<int> max_connections{"max_connections"};
+        const my_std::config_handle<int> connections = cfg.resolve(max_connections);
+        std::cout << "  max_connections (handle): " << cfg.get(connections) << "\n";
     }
 
     // Example 2: Event System
@@ -155,6 +131,11 @@ int main() {
             for (int x : *v) std::cout << x << " ";
             std::cout << "\n";
         }
+
+        container.add(58);
+        int int_total = 0;
+        container.for_each<int>([&](int x) { int_total += x; });
+        std::cout << "Sum of the ints: " << int_total << "\n";
     }
 
     // Example 4: Heterogeneous Collection
@@ -172,16 +153,16 @@ int main() {
             const auto& data = mixed_data[i];
             std::cout << "  [" << i << "] " << data.type().name();
             
-            // Runtime type checking
-            if (data.type() == typeid(int)) {
-                std::cout << " = " << my_std::any_cast<int>(data);
-            } else if (data.type() == typeid(const char*)) {
-                std::cout << " = " << my_std::any_cast<const char*>(data);
-            } else if (data.type() == typeid(double)) {
-                std::cout << " = " << my_std::any_cast<double>(data);
-            } else if (data.type() == typeid(bool)) {
-                std::cout << " = " << std::boolalpha 
-                          << my_std::any_cast<bool>(data);
+            // Runtime type checking: the pointer form of any_cast checks
+            // and extracts in one step, without comparing type_info
+            if (const auto* n = my_std::any_cast<int>(&data)) {
+                std::cout << " = " << *n;
+            } else if (const auto* s = my_std::any_cast<const char*>(&data)) {
+                std::cout << " = " << *s;
+            } else if (const auto* d = my_std::any_cast<double>(&data)) {
+                std::cout << " = " << *d;
+            } else if (const auto* b = my_std::any_cast<bool>(&data)) {
+                std::cout << " = " << std::boolalpha << *b;
             }
             std::cout << "\n";
         }
@@ -2,7 +2,10 @@
 #define MY_ANY_HPP
 
 #include <typeinfo>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <utility>
 #include <type_traits>
 #include <stdexcept>
@@ -18,53 +21,174 @@ public:
 
 class any {
 private:
-    // Base class for type erasure
-    struct placeholder {
-        virtual ~placeholder() = default;
-        virtual std::unique_ptr<placeholder> clone() const = 0;
-        virtual const std::type_info& type() const noexcept = 0;
+    // Type erasure through one static table of operations per stored type.
+    // The any holds a pointer to its value's table: comparing it with
+    // &manager<T>::table is the whole type check in any_cast, and the
+    // table's functions destroy, copy and move the value without virtual
+    // calls or a holder object around it.
+    struct operations {
+        void (*destroy)(any& self) noexcept;
+        // to must be empty; sets to.ops only once the copy succeeded. A heap
+        // copy is allocated from resource, or with new when it is null
+        void (*copy)(const any& from, any& to, std::pmr::memory_resource* resource);
+        // to must be empty; leaves from empty
+        void (*move)(any& from, any& to) noexcept;
+        const std::type_info& (*type)() noexcept;
     };
 
-    // Derived class template for holding actual values
+    // Room for a value of up to three pointers inside the any itself
+    static constexpr std::size_t buffer_size = 3 * sizeof(void*);
+    static constexpr std::size_t buffer_align = alignof(void*);
+
+    // Values stored inline: they must fit and be nothrow move constructible,
+    // so that moving and swapping an any stay noexcept
     template<typename ValueType>
-    struct holder : public placeholder {
+    static constexpr bool stored_inline =
+        sizeof(ValueType) <= buffer_size &&
+        alignof(ValueType) <= buffer_align &&
+        std::is_nothrow_move_constructible_v<ValueType>;
+
+    union storage {
+        void* heap;
+        alignas(buffer_align) unsigned char buffer[buffer_size];
+    };
+
+    // A value on the heap, with the memory resource it was allocated from;
+    // a null resource means new and delete
+    template<typename ValueType>
+    struct heap_block {
+        template<typename... Args>
+        explicit heap_block(std::pmr::memory_resource* r, Args&&... args)
+            : resource(r), value(std::forward<Args>(args)...) {}
+
+        std::pmr::memory_resource* resource;
         ValueType value;
+    };
 
-        template<typename T>
-        explicit holder(T&& val) 
-            : value(std::forward<T>(val)) {}
+    template<typename ValueType>
+    struct manager {
+        using block = heap_block<ValueType>;
+
+        static ValueType* get(any& self) noexcept {
+            if constexpr (stored_inline<ValueType>) {
+                return std::launder(reinterpret_cast<ValueType*>(self.data.buffer));
+            } else {
+                return &static_cast<block*>(self.data.heap)->value;
+            }
+        }
 
-        std::unique_ptr<placeholder> clone() const override {
-            return std::make_unique<holder<ValueType>>(value);
+        static const ValueType* get(const any& self) noexcept {
+            return get(const_cast<any&>(self));
         }
 
-        const std::type_info& type() const noexcept override {
+        // self must be empty. Inline values ignore resource
+        template<typename... Args>
+        static void create(any& self, std::pmr::memory_resource* resource, Args&&... args) {
+            if constexpr (stored_inline<ValueType>) {
+                ::new (static_cast<void*>(self.data.buffer)) ValueType(std::forward<Args>(args)...);
+            } else if (!resource) {
+                self.data.heap = new block(nullptr, std::forward<Args>(args)...);
+            } else {
+                void* memory = resource->allocate(sizeof(block), alignof(block));
+                try {
+                    self.data.heap = ::new (memory) block(resource, std::forward<Args>(args)...);
+                } catch (...) {
+                    resource->deallocate(memory, sizeof(block), alignof(block));
+                    throw;
+                }
+            }
+            self.ops = &table;
+        }
+
+        static void destroy(any& self) noexcept {
+            if constexpr (stored_inline<ValueType>) {
+                get(self)->~ValueType();
+            } else {
+                block* heap = static_cast<block*>(self.data.heap);
+                std::pmr::memory_resource* resource = heap->resource;
+                if (!resource) {
+                    delete heap;
+                } else {
+                    heap->~block();
+                    resource->deallocate(heap, sizeof(block), alignof(block));
+                }
+            }
+        }
+
+        static void copy(const any& from, any& to, std::pmr::memory_resource* resource) {
+            create(to, resource, *get(from));
+        }
+
+        static void move(any& from, any& to) noexcept {
+            if constexpr (stored_inline<ValueType>) {
+                ::new (static_cast<void*>(to.data.buffer)) ValueType(std::move(*get(from)));
+                get(from)->~ValueType();
+            } else {
+                to.data.heap = from.data.heap;
+            }
+            to.ops = from.ops;
+            from.ops = nullptr;
+        }
+
+        static const std::type_info& type() noexcept {
             return typeid(ValueType);
         }
+
+        static constexpr operations table = {&destroy, &copy, &move, &type};
     };
 
-    std::unique_ptr<placeholder> content;
+    storage data;
+    const operations* ops = nullptr;
 
 public:
     // Constructors
-    constexpr any() noexcept = default;
+    constexpr any() noexcept : data() {}
 
+    // A copy goes to new and delete, whatever resource other's value uses
     any(const any& other) {
-        if (other.content) {
-            content = other.content->clone();
+        if (other.ops) {
+            other.ops->copy(other, *this, nullptr);
         }
     }
 
-    any(any&& other) noexcept = default;
+    any(any&& other) noexcept {
+        if (other.ops) {
+            other.ops->move(other, *this);
+        }
+    }
+
+    template<typename ValueType,
+             typename = std::enable_if_t<!std::is_same_v<std::decay_t<ValueType>, any>>>
+    any(ValueType&& value) {
+        manager<std::decay_t<ValueType>>::create(*this, nullptr, std::forward<ValueType>(value));
+    }
 
+    // Allocator-aware construction: a value too large for the inline buffer
+    // is allocated from resource instead of with new, and given back to it
+    // when the any lets go of the value. With a monotonic_buffer_resource
+    // that deallocation does nothing and the memory is reclaimed in bulk by
+    // its release(); an unsynchronized_pool_resource recycles blocks by size
+    // class. A null resource means new and delete.
+    //
+    // The value keeps its resource when the any is moved or swapped, so the
+    // resource must outlive it; copy it (plain copies use new) to keep it
+    // past the resource's release().
     template<typename ValueType,
              typename = std::enable_if_t<!std::is_same_v<std::decay_t<ValueType>, any>>>
-    any(ValueType&& value) 
-        : content(std::make_unique<holder<std::decay_t<ValueType>>>(
-            std::forward<ValueType>(value))) {}
+    any(std::allocator_arg_t, std::pmr::memory_resource* resource, ValueType&& value) {
+        manager<std::decay_t<ValueType>>::create(*this, resource, std::forward<ValueType>(value));
+    }
+
+    any(std::allocator_arg_t, std::pmr::memory_resource* resource, const any& other) {
+        if (other.ops) {
+            other.ops->copy(other, *this, resource);
+        }
+    }
 
     // Destructor
-    ~any() = default;
+    ~any() {
+        reset();
+    }
 
     // Assignment operators
     any& operator=(const any& rhs) {
@@ -73,7 +197,12 @@ public:
     }
 
     any& operator=(any&& rhs) noexcept {
-        any(std::move(rhs)).swap(*this);
+        if (this != &rhs) {
+            reset();
+            if (rhs.ops) {
+                rhs.ops->move(rhs, *this);
+            }
+        }
         return *this;
     }
 
@@ -86,23 +215,31 @@ public:
 
     // Modifiers
     void reset() noexcept {
-        content.reset();
+        if (ops) {
+            ops->destroy(*this);
+            ops = nullptr;
+        }
     }
 
     void swap(any& other) noexcept {
-        content.swap(other.content);
+        if (this == &other) {
+            return;
+        }
+        any tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
     }
 
     // Observers
     bool has_value() const noexcept {
-        return content != nullptr;
+        return ops != nullptr;
     }
 
     const std::type_info& type() const noexcept {
-        if (!content) {
+        if (!ops) {
             return typeid(void);
         }
-        return content->type();
+        return ops->type();
     }
 
     // Friend function for any_cast
@@ -171,24 +308,25 @@ T any_cast(any&& operand) {
     }
 }
 
+// The type check compares table pointers. Each stored type has exactly one
+// table per program, but a value stored by a separately built shared library
+// may carry that library's copy of the table and so not match.
 template<typename T>
 const T* any_cast(const any* operand) noexcept {
-    if (!operand || operand->type() != typeid(T)) {
+    using manager = any::manager<std::remove_cv_t<T>>;
+    if (!operand || operand->ops != &manager::table) {
         return nullptr;
     }
-    
-    const auto* holder = static_cast<const any::holder<T>*>(operand->content.get());
-    return &holder->value;
+    return manager::get(*operand);
 }
 
 template<typename T>
 T* any_cast(any* operand) noexcept {
-    if (!operand || operand->type() != typeid(T)) {
+    using manager = any::manager<std::remove_cv_t<T>>;
+    if (!operand || operand->ops != &manager::table) {
         return nullptr;
     }
-    
-    auto* holder = static_cast<any::holder<T>*>(operand->content.get());
-    return &holder->value;
+    return manager::get(*operand);
 }
 
 // Non-member swap
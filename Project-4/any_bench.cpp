@@ -0,0 +1,377 @@
+// Micro-benchmark: my_std::any against std::any.
+//
+// Usage: any_bench [iterations] [repetitions]
+//
+// For values of several sizes, times constructing (and destroying) an any,
+// copying it, moving it, and any_cast, and counts heap allocations per
+// operation through a replaced global operator new. Then fills and drops
+// frames of heap-sized events, with my_std::any allocating from new, a
+// monotonic arena released after each frame, or a pool resource. Last, sums
+// the ints of a mixed sequence held in a std::vector of anys and in an
+// any_collection, against a std::vector<int> of the same ints, and times
+// config reads from a std::map<std::string, any> and from ConfigManager by
+// string, by config_key and by handle. The final table compares the read
+// throughput of a mutex-guarded ConfigManager and a ConcurrentConfigManager
+// as reader threads are added, with a writer publishing now and then.
+
+#include "any.hpp"
+#include "any_collection.hpp"
+#include "concurrent_config.hpp"
+#include "config_manager.hpp"
+#include "counting_new.hpp"
+#include <algorithm>
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::uint64_t sink;
+
+struct measurement {
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+template<typename F>
+measurement measure(std::size_t iterations, std::size_t repetitions, F&& run) {
+    double best = 0;
+    std::uint64_t allocs = 0;
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        const std::uint64_t before = my_std::allocation_count();
+        const Clock::time_point start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            run(i);
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        allocs = my_std::allocation_count() - before;
+        if (r == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return {best * 1e9 / double(iterations), double(allocs) / double(iterations)};
+}
+
+// Three pointers: the largest value my_std::any keeps inline
+struct triple {
+    const void* a;
+    const void* b;
+    const void* c;
+};
+
+template<typename Any, typename Cast>
+void run_type(const char* name, const typename Cast::value_type& value, std::size_t iterations,
+              std::size_t repetitions) {
+    using T = typename Cast::value_type;
+    const Any source = value;
+    Any moving = value;
+
+    const measurement construct = measure(iterations, repetitions, [&](std::size_t) {
+        Any a = value;
+        sink = a.has_value();
+    });
+    const measurement copy = measure(iterations, repetitions, [&](std::size_t) {
+        Any a = source;
+        sink = a.has_value();
+    });
+    const measurement move = measure(iterations, repetitions, [&](std::size_t) {
+        Any a = std::move(moving);
+        moving = std::move(a);
+        sink = moving.has_value();
+    });
+    const measurement cast = measure(iterations, repetitions, [&](std::size_t) {
+        const T* p = Cast::get(source);
+        sink = p != nullptr;
+    });
+
+    std::cout << std::setw(14) << name << std::fixed << std::setprecision(2);
+    for (const measurement& m : {construct, copy, move, cast}) {
+        std::cout << std::setw(9) << m.ns_per_op << std::setw(6) << std::setprecision(1) << m.allocs_per_op
+                  << std::setprecision(2);
+    }
+    std::cout << '\n';
+}
+
+template<typename T>
+struct my_cast {
+    using value_type = T;
+    static const T* get(const my_std::any& a) { return my_std::any_cast<T>(&a); }
+};
+
+template<typename T>
+struct std_cast {
+    using value_type = T;
+    static const T* get(const std::any& a) { return std::any_cast<T>(&a); }
+};
+
+template<typename T>
+void compare(const char* name, const T& value, std::size_t iterations, std::size_t repetitions) {
+    std::cout << name << " (" << sizeof(T) << " bytes)\n";
+    run_type<my_std::any, my_cast<T>>("my_std::any", value, iterations, repetitions);
+    run_type<std::any, std_cast<T>>("std::any", value, iterations, repetitions);
+}
+
+// Too large for any inline buffer
+struct event {
+    std::uint64_t id;
+    char payload[56];
+};
+
+constexpr std::size_t events_per_frame = 1000;
+
+// Times one frame: make() adds events_per_frame events to events, which are
+// then dropped, and end_frame() runs. Reported per event.
+template<typename Any, typename Make, typename EndFrame>
+void run_frames(const char* name, std::size_t iterations, std::size_t repetitions, Make&& make,
+                EndFrame&& end_frame) {
+    std::vector<Any> events;
+    events.reserve(events_per_frame);
+    const std::size_t frames = iterations / events_per_frame != 0 ? iterations / events_per_frame : 1;
+    const measurement m = measure(frames, repetitions, [&](std::size_t frame) {
+        for (std::size_t i = 0; i < events_per_frame; ++i) {
+            make(events, event{frame * events_per_frame + i, {}});
+        }
+        sink = events.size();
+        events.clear();
+        end_frame();
+    });
+    std::cout << std::setw(24) << name << std::fixed << std::setprecision(2) << std::setw(9)
+              << m.ns_per_op / events_per_frame << std::setw(8) << std::setprecision(3)
+              << m.allocs_per_op / events_per_frame << '\n';
+}
+
+void frames(std::size_t iterations, std::size_t repetitions) {
+    std::cout << "\nframes of " << events_per_frame << " events (" << sizeof(event)
+              << " bytes), ns and allocations per event\n";
+    const auto nothing = [] {};
+
+    run_frames<std::any>("std::any", iterations, repetitions,
+                         [](std::vector<std::any>& events, const event& e) { events.emplace_back(e); }, nothing);
+    run_frames<my_std::any>("my_std::any, new", iterations, repetitions,
+                            [](std::vector<my_std::any>& events, const event& e) { events.emplace_back(e); },
+                            nothing);
+
+    // Room for a frame's events, reused after every release()
+    std::vector<unsigned char> frame_buffer(events_per_frame * 2 * sizeof(event));
+    std::pmr::monotonic_buffer_resource arena(frame_buffer.data(), frame_buffer.size());
+    run_frames<my_std::any>(
+        "my_std::any, arena", iterations, repetitions,
+        [&](std::vector<my_std::any>& events, const event& e) { events.emplace_back(std::allocator_arg, &arena, e); },
+        [&] { arena.release(); });
+
+    std::pmr::unsynchronized_pool_resource pool;
+    run_frames<my_std::any>(
+        "my_std::any, pool", iterations, repetitions,
+        [&](std::vector<my_std::any>& events, const event& e) { events.emplace_back(std::allocator_arg, &pool, e); },
+        nothing);
+}
+
+constexpr std::size_t visit_elements = 1 << 16;
+
+void report_visit(const char* name, const measurement& m, std::size_t ints) {
+    std::cout << std::setw(24) << name << std::fixed << std::setprecision(3) << std::setw(9)
+              << m.ns_per_op / double(ints) << '\n';
+}
+
+template<typename Any, typename Cast>
+void visit_anys(const char* name, std::size_t iterations, std::size_t repetitions, std::size_t ints) {
+    std::vector<Any> items;
+    for (std::size_t i = 0; i < visit_elements; ++i) {
+        if (i % 4 == 3) {
+            items.emplace_back(double(i));
+        } else {
+            items.emplace_back(int(i));
+        }
+    }
+    report_visit(name, measure(iterations, repetitions, [&](std::size_t) {
+        std::uint64_t total = 0;
+        for (const Any& item : items) {
+            if (const int* x = Cast::get(item)) {
+                total += *x;
+            }
+        }
+        sink = total;
+    }), ints);
+}
+
+// One element in four is a double, the rest ints; ns per int visited
+void visit(std::size_t iterations, std::size_t repetitions) {
+    const std::size_t passes = iterations / visit_elements != 0 ? iterations / visit_elements : 1;
+    std::vector<int> plain;
+    my_std::any_collection collection;
+    for (std::size_t i = 0; i < visit_elements; ++i) {
+        if (i % 4 == 3) {
+            collection.push_back(double(i));
+        } else {
+            plain.push_back(int(i));
+            collection.push_back(int(i));
+        }
+    }
+    const std::size_t ints = plain.size();
+    std::cout << "\nsumming the ints of " << visit_elements << " elements (1 in 4 a double), ns per int\n";
+
+    report_visit("std::vector<int>", measure(passes, repetitions, [&](std::size_t) {
+        std::uint64_t total = 0;
+        for (int x : plain) {
+            total += x;
+        }
+        sink = total;
+    }), ints);
+    report_visit("any_collection", measure(passes, repetitions, [&](std::size_t) {
+        std::uint64_t total = 0;
+        collection.for_each<int>([&](int x) { total += x; });
+        sink = total;
+    }), ints);
+    visit_anys<my_std::any, my_cast<int>>("std::vector<my_std::any>", passes, repetitions, ints);
+    visit_anys<std::any, std_cast<int>>("std::vector<std::any>", passes, repetitions, ints);
+}
+
+// The map lookup the original ConfigManager did: a std::string key built
+// from the caller's literal, a tree walk and a copy of the value
+int map_get(const std::map<std::string, my_std::any>& config, const std::string& key) {
+    return my_std::any_cast<int>(config.find(key)->second);
+}
+
+void config(std::size_t iterations, std::size_t repetitions) {
+    static constexpr my_std::config_key<int> key{"server.max_connections"};
+    std::map<std::string, my_std::any> map_config;
+    my_std::ConfigManager flat_config;
+    for (int i = 0; i < 32; ++i) {
+        map_config["server.setting_" + std::to_string(i)] = i;
+        flat_config.set("server.setting_" + std::to_string(i), i);
+    }
+    map_config["server.max_connections"] = 100;
+    flat_config.set(key, 100);
+    const my_std::config_handle<int> handle = flat_config.resolve(key);
+
+    const auto report = [](const char* name, const measurement& m) {
+        std::cout << std::setw(24) << name << std::fixed << std::setprecision(2) << std::setw(9) << m.ns_per_op
+                  << std::setw(6) << std::setprecision(1) << m.allocs_per_op << '\n';
+    };
+    std::cout << "\nreading an int from 33 config entries, ns/op and allocations/op\n";
+    report("std::map, std::string", measure(iterations, repetitions, [&](std::size_t) {
+        sink = map_get(map_config, "server.max_connections");
+    }));
+    report("ConfigManager, string", measure(iterations, repetitions, [&](std::size_t) {
+        sink = flat_config.get<int>("server.max_connections");
+    }));
+    report("ConfigManager, key", measure(iterations, repetitions, [&](std::size_t) {
+        sink = flat_config.get(key);
+    }));
+    report("ConfigManager, handle", measure(iterations, repetitions, [&](std::size_t) {
+        sink = flat_config.get(handle);
+    }));
+}
+
+// Runs read(reads) on each of threads threads while the calling thread calls
+// write() every millisecond; returns millions of reads per second, all
+// threads together. What the reads return is kept, after the threads join
+template<typename Read, typename Write>
+double read_throughput(std::size_t threads, std::size_t reads, Read&& read, Write&& write) {
+    std::atomic<std::size_t> running{threads};
+    std::vector<std::uint64_t> results(threads);
+    std::vector<std::thread> workers;
+    const Clock::time_point start = Clock::now();
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            results[t] = read(reads);
+            --running;
+        });
+    }
+    while (running.load() != 0) {
+        write();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::uint64_t total = 0;
+    for (std::uint64_t result : results) {
+        total += result;
+    }
+    sink = total;
+    return double(threads * reads) / seconds / 1e6;
+}
+
+void concurrent_config(std::size_t iterations, std::size_t repetitions) {
+    static constexpr my_std::config_key<int> key{"server.max_connections"};
+    my_std::ConfigManager guarded;
+    std::mutex guard;
+    const my_std::config_handle<int> guarded_handle = guarded.resolve(key);
+    guarded.set(guarded_handle, 100);
+    my_std::ConcurrentConfigManager shared;
+    const my_std::config_handle<int> shared_handle = shared.resolve(key);
+    shared.set(key, 100);
+
+    std::cout << "\nconcurrent reads by handle, a write every ms, millions of reads/s in total\n"
+              << std::setw(24) << "threads" << std::setw(9) << "mutex" << std::setw(9) << "snapshot" << '\n';
+    for (std::size_t threads : {1, 2, 4, 8}) {
+        double with_mutex = 0;
+        double with_snapshots = 0;
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            with_mutex = std::max(with_mutex, read_throughput(threads, iterations, [&](std::size_t reads) {
+                std::uint64_t total = 0;
+                for (std::size_t i = 0; i < reads; ++i) {
+                    std::lock_guard<std::mutex> lock(guard);
+                    total += guarded.get(guarded_handle);
+                }
+                return total;
+            }, [&] {
+                std::lock_guard<std::mutex> lock(guard);
+                guarded.set(guarded_handle, guarded.get(guarded_handle) + 1);
+            }));
+            with_snapshots = std::max(with_snapshots, read_throughput(threads, iterations, [&](std::size_t reads) {
+                const my_std::ConcurrentConfigManager::reader reader = shared.make_reader();
+                std::uint64_t total = 0;
+                for (std::size_t i = 0; i < reads; ++i) {
+                    total += reader.read()->get(shared_handle);
+                }
+                return total;
+            }, [&] {
+                shared.update([&](my_std::ConfigManager& next) { next.set(shared_handle, next.get(shared_handle) + 1); });
+            }));
+        }
+        std::cout << std::setw(24) << threads << std::fixed << std::setprecision(1) << std::setw(9) << with_mutex
+                  << std::setw(9) << with_snapshots << '\n';
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    if (iterations == 0 || repetitions == 0) {
+        std::cerr << "usage: any_bench [iterations] [repetitions]\n";
+        return 1;
+    }
+
+    std::cout << "sizeof(my_std::any) = " << sizeof(my_std::any) << ", sizeof(std::any) = " << sizeof(std::any)
+              << "\n\nns/op and allocations/op\n"
+              << std::setw(14) << "" << std::setw(15) << "construct" << std::setw(15) << "copy" << std::setw(15)
+              << "move" << std::setw(15) << "any_cast" << '\n';
+    const int marker = 0;
+    compare("int", 42, iterations, repetitions);
+    compare("double", 3.14, iterations, repetitions);
+    compare("triple", triple{&marker, &marker, &marker}, iterations, repetitions);
+    compare("std::vector<int>", std::vector<int>{1, 2, 3}, iterations, repetitions);
+    compare("std::string", std::string("a string too long for SSO"), iterations, repetitions);
+    frames(iterations, repetitions);
+    visit(iterations, repetitions);
+    config(iterations, repetitions);
+    concurrent_config(iterations, repetitions);
+    return 0;
+}
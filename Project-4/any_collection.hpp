@@ -0,0 +1,153 @@
+#ifndef MY_ANY_COLLECTION_HPP
+#define MY_ANY_COLLECTION_HPP
+
+#include "any.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace my_std {
+
+// A heterogeneous sequence that stores its elements grouped by type: all
+// the ints in one std::vector<int>, all the strings in one
+// std::vector<std::string>, and so on. Each of those segments is held in a
+// my_std::any (a std::vector fits its inline buffer), and an index keeps,
+// for every element in insertion order, its segment and its position there.
+//
+// for_each<T> finds T's segment once and then walks a plain std::vector<T>:
+// no type check and no pointer chase per element, unlike a
+// std::vector<any>, where every element is checked and large ones live in
+// separate heap blocks. get<T>(i) and type(i) still give access in
+// insertion order.
+//
+// Elements are never removed one by one, so an element's index never
+// changes; clear() empties the collection. As with std::vector, adding an
+// element of type T invalidates pointers to the other T elements.
+class any_collection {
+private:
+    struct segment {
+        const std::type_info* type;  // of the elements
+        any values;                  // std::vector<T>
+    };
+
+    struct entry {
+        std::uint32_t segment;
+        std::uint32_t position;
+    };
+
+    template<typename T>
+    static std::vector<T>* values(segment& s) noexcept {
+        return any_cast<std::vector<T>>(&s.values);
+    }
+
+    template<typename T>
+    static const std::vector<T>* values(const segment& s) noexcept {
+        return any_cast<std::vector<T>>(&s.values);
+    }
+
+    template<typename T>
+    std::size_t find_segment() const noexcept {
+        for (std::size_t i = 0; i < segments.size(); ++i) {
+            if (values<T>(segments[i])) {
+                return i;
+            }
+        }
+        return segments.size();
+    }
+
+    std::vector<segment> segments;
+    std::vector<entry> index;
+
+public:
+    // Capacity
+    std::size_t size() const noexcept {
+        return index.size();
+    }
+
+    bool empty() const noexcept {
+        return index.empty();
+    }
+
+    // Number of distinct element types
+    std::size_t segment_count() const noexcept {
+        return segments.size();
+    }
+
+    // Number of elements of type T
+    template<typename T>
+    std::size_t count() const noexcept {
+        const std::size_t s = find_segment<T>();
+        return s == segments.size() ? 0 : values<T>(segments[s])->size();
+    }
+
+    // Modifiers
+    template<typename ValueType>
+    void push_back(ValueType&& value) {
+        using T = std::decay_t<ValueType>;
+        std::size_t s = find_segment<T>();
+        if (s == segments.size()) {
+            segments.push_back(segment{&typeid(T), any(std::vector<T>())});
+        }
+        std::vector<T>& target = *values<T>(segments[s]);
+        index.reserve(index.size() + 1);
+        target.push_back(std::forward<ValueType>(value));
+        index.push_back(entry{static_cast<std::uint32_t>(s), static_cast<std::uint32_t>(target.size() - 1)});
+    }
+
+    void clear() noexcept {
+        segments.clear();
+        index.clear();
+    }
+
+    // Element access in insertion order: nullptr when index is past the end
+    // or the element is not a T
+    template<typename T>
+    T* get(std::size_t i) noexcept {
+        if (i >= index.size()) {
+            return nullptr;
+        }
+        std::vector<T>* v = values<T>(segments[index[i].segment]);
+        return v ? &(*v)[index[i].position] : nullptr;
+    }
+
+    template<typename T>
+    const T* get(std::size_t i) const noexcept {
+        return const_cast<any_collection*>(this)->get<T>(i);
+    }
+
+    const std::type_info& type(std::size_t i) const {
+        if (i >= index.size()) {
+            throw std::out_of_range("any_collection: index out of range");
+        }
+        return *segments[index[i].segment].type;
+    }
+
+    // Calls f on every element of type T, in insertion order among them
+    template<typename T, typename F>
+    void for_each(F&& f) {
+        const std::size_t s = find_segment<T>();
+        if (s != segments.size()) {
+            for (T& value : *values<T>(segments[s])) {
+                f(value);
+            }
+        }
+    }
+
+    template<typename T, typename F>
+    void for_each(F&& f) const {
+        const std::size_t s = find_segment<T>();
+        if (s != segments.size()) {
+            for (const T& value : *values<T>(segments[s])) {
+                f(value);
+            }
+        }
+    }
+};
+
+} // namespace my_std
+
+#endif // MY_ANY_COLLECTION_HPP
@@ -0,0 +1,215 @@
+#ifndef MY_CONCURRENT_CONFIG_HPP
+#define MY_CONCURRENT_CONFIG_HPP
+
+#include "config_manager.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace my_std {
+
+// A ConfigManager shared between threads that read it constantly and a few
+// that rewrite it now and then.
+//
+// The configuration is an immutable ConfigManager behind an atomic pointer.
+// A writer copies the current table, changes the copy and publishes it with
+// one atomic exchange, so readers see every update whole. Readers never take
+// a lock: each reading thread registers a reader, and a snapshot marks that
+// reader as active in the current epoch (one store to the reader's own cache
+// line) and loads the table pointer. Nothing is shared between readers but
+// the read-mostly epoch counter and table pointer, so reading scales with
+// threads.
+//
+// Replaced tables are freed by a later writer, once no active reader
+// started before they were replaced (epoch-based reclamation). A snapshot
+// therefore keeps its table, and references into it, valid until it is
+// destroyed; hold it only as long as a read takes.
+//
+// Entries are copied with their positions, so a config_handle from
+// resolve() works with every snapshot taken after resolve() returned.
+class ConcurrentConfigManager {
+private:
+    struct alignas(64) reader_record {
+        std::atomic<std::uint64_t> epoch{0};  // 0 while no snapshot is held
+        std::uint32_t snapshots = 0;          // held; only the reading thread uses it
+        bool in_use = false;                  // guarded by write_mutex
+    };
+
+    struct retired_table {
+        const ConfigManager* table;
+        std::uint64_t epoch;  // the epoch it was replaced in
+    };
+
+public:
+    // A published version of the configuration, kept alive while held
+    class snapshot {
+    public:
+        snapshot(snapshot&& other) noexcept
+            : record(std::exchange(other.record, nullptr)), table(other.table) {}
+
+        snapshot& operator=(snapshot&&) = delete;
+
+        ~snapshot() {
+            if (record && --record->snapshots == 0) {
+                record->epoch.store(0, std::memory_order_release);
+            }
+        }
+
+        const ConfigManager& operator*() const noexcept { return *table; }
+        const ConfigManager* operator->() const noexcept { return table; }
+
+    private:
+        friend class ConcurrentConfigManager;
+
+        snapshot(reader_record* r, const ConfigManager* t) noexcept : record(r), table(t) {}
+
+        reader_record* record;
+        const ConfigManager* table;
+    };
+
+    // One per reading thread; it must not outlive its ConcurrentConfigManager
+    class reader {
+    public:
+        reader(reader&& other) noexcept
+            : owner(std::exchange(other.owner, nullptr)), record(other.record) {}
+
+        reader& operator=(reader&&) = delete;
+
+        ~reader() {
+            if (owner) {
+                owner->release_reader(record);
+            }
+        }
+
+        // Wait-free. Snapshots may nest: the epoch announced by the first
+        // one protects every table loaded until the last one is released.
+        // Snapshots must be destroyed on the thread that took them
+        snapshot read() const noexcept {
+            if (record->snapshots++ == 0) {
+                record->epoch.store(owner->epoch.load());
+            }
+            return snapshot(record, owner->current.load());
+        }
+
+    private:
+        friend class ConcurrentConfigManager;
+
+        reader(ConcurrentConfigManager* o, reader_record* r) noexcept : owner(o), record(r) {}
+
+        ConcurrentConfigManager* owner;
+        reader_record* record;
+    };
+
+    ConcurrentConfigManager() : current(new ConfigManager()) {}
+
+    explicit ConcurrentConfigManager(const ConfigManager& initial) : current(new ConfigManager(initial)) {}
+
+    ConcurrentConfigManager(const ConcurrentConfigManager&) = delete;
+    ConcurrentConfigManager& operator=(const ConcurrentConfigManager&) = delete;
+
+    // No reader or snapshot may remain
+    ~ConcurrentConfigManager() {
+        delete current.load();
+        for (const retired_table& r : retired) {
+            delete r.table;
+        }
+    }
+
+    reader make_reader() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        auto free_record = std::find_if(readers.begin(), readers.end(),
+                                        [](const std::unique_ptr<reader_record>& r) { return !r->in_use; });
+        if (free_record == readers.end()) {
+            readers.push_back(std::make_unique<reader_record>());
+            free_record = readers.end() - 1;
+        }
+        (*free_record)->in_use = true;
+        return reader(this, free_record->get());
+    }
+
+    // Calls f(ConfigManager&) on a copy of the current table and publishes
+    // the copy; if f throws, nothing is published. Writers are serialized
+    template<typename F>
+    void update(F&& f) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        auto next = std::make_unique<ConfigManager>(*current.load());
+        f(*next);
+        retired.reserve(retired.size() + 1);
+        publish(next.release());
+    }
+
+    template<typename Key, typename T>
+    void set(const Key& key, T&& value) {
+        update([&](ConfigManager& next) { next.set(key, std::forward<T>(value)); });
+    }
+
+    // Publishes a version with key's entry, added without a value if missing
+    template<typename T>
+    config_handle<T> resolve(const config_key<T>& key) {
+        config_handle<T> handle;
+        update([&](ConfigManager& next) { handle = next.resolve(key); });
+        return handle;
+    }
+
+    // Frees the replaced tables no snapshot can still see; writers also do
+    // this after each update
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        reclaim_retired();
+    }
+
+    // Replaced tables not freed yet
+    std::size_t retired_count() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return retired.size();
+    }
+
+private:
+    // Called with write_mutex held
+    void publish(const ConfigManager* next) noexcept {
+        const ConfigManager* old = current.exchange(next);
+        retired.push_back(retired_table{old, epoch.fetch_add(1)});
+        reclaim_retired();
+    }
+
+    // A snapshot of a table replaced in epoch e was taken by a reader that
+    // had announced an epoch of at most e, so the table can go once every
+    // active reader is past e
+    void reclaim_retired() noexcept {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+        for (const std::unique_ptr<reader_record>& r : readers) {
+            const std::uint64_t e = r->epoch.load();
+            if (e != 0 && e < oldest) {
+                oldest = e;
+            }
+        }
+        auto kept = std::remove_if(retired.begin(), retired.end(), [&](const retired_table& r) {
+            if (r.epoch < oldest) {
+                delete r.table;
+                return true;
+            }
+            return false;
+        });
+        retired.erase(kept, retired.end());
+    }
+
+    void release_reader(reader_record* record) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        record->in_use = false;
+    }
+
+    std::atomic<const ConfigManager*> current;
+    std::atomic<std::uint64_t> epoch{1};
+    std::mutex write_mutex;
+    std::vector<std::unique_ptr<reader_record>> readers;  // guarded by write_mutex
+    std::vector<retired_table> retired;                   // guarded by write_mutex
+};
+
+} // namespace my_std
+
+#endif // MY_CONCURRENT_CONFIG_HPP
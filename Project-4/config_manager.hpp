@@ -0,0 +1,238 @@
+#ifndef MY_CONFIG_MANAGER_HPP
+#define MY_CONFIG_MANAGER_HPP
+
+#include "any.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace my_std {
+
+// 64-bit FNV-1a, usable in constant expressions
+constexpr std::uint64_t config_hash(std::string_view name) noexcept {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// A configuration key with the type of its value. Declared constexpr, its
+// hash is computed at compile time:
+//
+//     constexpr my_std::config_key<int> max_connections{"max_connections"};
+template<typename T>
+class config_key {
+public:
+    using value_type = T;
+
+    constexpr explicit config_key(std::string_view name) noexcept
+        : key_name(name), key_hash(config_hash(name)) {}
+
+    constexpr std::string_view name() const noexcept { return key_name; }
+    constexpr std::uint64_t hash() const noexcept { return key_hash; }
+
+private:
+    std::string_view key_name;
+    std::uint64_t key_hash;
+};
+
+// A key resolved by one ConfigManager: the position of its entry there
+template<typename T>
+class config_handle {
+public:
+    using value_type = T;
+
+    constexpr config_handle() noexcept = default;
+
+private:
+    friend class ConfigManager;
+
+    constexpr explicit config_handle(std::uint32_t i) noexcept : index(i) {}
+
+    std::uint32_t index = 0;
+};
+
+// Configuration values of any type, by name.
+//
+// Entries live in a vector in the order they were added and are never
+// removed, so the position of an entry stays valid: a config_handle is that
+// position, and reading through it is one indexed load plus any_cast's
+// pointer comparison. Names are found through an open-addressing table of
+// entry positions (linear probing, at most half full) keyed by the hash, so
+// a lookup by string hashes once, probes a flat array and compares the name
+// only on a hash match; a config_key brings its hash precomputed.
+//
+// get() returns a const reference to the stored value. It stays valid until
+// the value is replaced, or until a new key is added (which may move the
+// entries).
+class ConfigManager {
+private:
+    struct entry {
+        std::string name;
+        std::uint64_t hash;
+        any value;
+    };
+
+    static constexpr std::uint32_t empty_slot = 0xffffffffu;
+
+    std::vector<entry> entries;
+    std::vector<std::uint32_t> slots;  // entry positions, or empty_slot
+
+    std::size_t find(std::string_view name, std::uint64_t hash) const noexcept {
+        if (slots.empty()) {
+            return npos;
+        }
+        const std::size_t mask = slots.size() - 1;
+        for (std::size_t s = hash & mask;; s = (s + 1) & mask) {
+            const std::uint32_t i = slots[s];
+            if (i == empty_slot) {
+                return npos;
+            }
+            if (entries[i].hash == hash && entries[i].name == name) {
+                return i;
+            }
+        }
+    }
+
+    void insert_slot(std::uint32_t i) noexcept {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t s = entries[i].hash & mask;
+        while (slots[s] != empty_slot) {
+            s = (s + 1) & mask;
+        }
+        slots[s] = i;
+    }
+
+    // The entry for name, added without a value when missing
+    std::size_t find_or_add(std::string_view name, std::uint64_t hash) {
+        const std::size_t found = find(name, hash);
+        if (found != npos) {
+            return found;
+        }
+        if ((entries.size() + 1) * 2 > slots.size()) {
+            std::vector<std::uint32_t> grown(slots.empty() ? 16 : slots.size() * 2, empty_slot);
+            slots.swap(grown);
+            for (std::uint32_t i = 0; i < entries.size(); ++i) {
+                insert_slot(i);
+            }
+        }
+        entries.push_back(entry{std::string(name), hash, any()});
+        insert_slot(static_cast<std::uint32_t>(entries.size() - 1));
+        return entries.size() - 1;
+    }
+
+    template<typename T>
+    const T& value_at(std::size_t i) const {
+        const any& value = entries[i].value;
+        if (const T* result = any_cast<T>(&value)) {
+            return *result;
+        }
+        if (!value.has_value()) {
+            throw std::runtime_error("Key not set: " + entries[i].name);
+        }
+        throw bad_any_cast();
+    }
+
+    [[noreturn]] static void not_found(std::string_view name) {
+        throw std::runtime_error("Key not found: " + std::string(name));
+    }
+
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Lookup by name, for keys only known at run time
+    template<typename T>
+    void set(std::string_view key, T&& value) {
+        entries[find_or_add(key, config_hash(key))].value = std::forward<T>(value);
+    }
+
+    // Throws std::runtime_error for a missing key and bad_any_cast when the
+    // value is not a T
+    template<typename T>
+    const T& get(std::string_view key) const {
+        const std::size_t i = find(key, config_hash(key));
+        if (i == npos) {
+            not_found(key);
+        }
+        return value_at<T>(i);
+    }
+
+    template<typename T>
+    T get_or_default(std::string_view key, const T& default_value) const {
+        const std::size_t i = find(key, config_hash(key));
+        if (i == npos) {
+            return default_value;
+        }
+        const T* result = any_cast<T>(&entries[i].value);
+        return result ? *result : default_value;
+    }
+
+    bool contains(std::string_view key) const noexcept {
+        const std::size_t i = find(key, config_hash(key));
+        return i != npos && entries[i].value.has_value();
+    }
+
+    // Typed keys: no hashing at run time
+    template<typename T, typename U>
+    void set(const config_key<T>& key, U&& value) {
+        entries[find_or_add(key.name(), key.hash())].value = T(std::forward<U>(value));
+    }
+
+    template<typename T>
+    const T& get(const config_key<T>& key) const {
+        const std::size_t i = find(key.name(), key.hash());
+        if (i == npos) {
+            not_found(key.name());
+        }
+        return value_at<T>(i);
+    }
+
+    // A handle to key's entry, which is added without a value when missing,
+    // so handles can be resolved before the values are loaded
+    template<typename T>
+    config_handle<T> resolve(const config_key<T>& key) {
+        return config_handle<T>(static_cast<std::uint32_t>(find_or_add(key.name(), key.hash())));
+    }
+
+    // h must come from this ConfigManager. Throws std::runtime_error when
+    // the entry has no value yet and bad_any_cast when it is not a T
+    template<typename T>
+    const T& get(config_handle<T> h) const {
+        return value_at<T>(h.index);
+    }
+
+    template<typename T, typename U>
+    void set(config_handle<T> h, U&& value) {
+        entries[h.index].value = T(std::forward<U>(value));
+    }
+
+    std::size_t size() const noexcept {
+        return entries.size();
+    }
+
+    // Keys sorted by name
+    void print_all() const {
+        std::vector<const entry*> sorted;
+        sorted.reserve(entries.size());
+        for (const entry& e : entries) {
+            sorted.push_back(&e);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const entry* a, const entry* b) { return a->name < b->name; });
+        std::cout << "Configuration:\n";
+        for (const entry* e : sorted) {
+            std::cout << "  " << e->name << ": " << e->value.type().name() << "\n";
+        }
+    }
+};
+
+} // namespace my_std
+
+#endif // MY_CONFIG_MANAGER_HPP
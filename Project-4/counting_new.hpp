@@ -0,0 +1,53 @@
+#ifndef MY_COUNTING_NEW_HPP
+#define MY_COUNTING_NEW_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new and delete with malloc and free, counting
+// every allocation, for the benchmarks. Replacement allocation functions
+// cannot be inline, so include this header in exactly one translation unit
+// of a program.
+
+namespace my_std {
+
+inline std::atomic<std::uint64_t> allocations{0};
+
+// Heap allocations made through operator new since the program started, by
+// all threads
+inline std::uint64_t allocation_count() noexcept {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace my_std
+
+void* operator new(std::size_t size) {
+    my_std::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC inlines these into callers of the builtin operator new and then reports
+// free() on memory from new; here that pairing is the point
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // MY_COUNTING_NEW_HPP
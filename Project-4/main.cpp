@@ -1,6 +1,11 @@
 #include "any.hpp"
+#include "any_collection.hpp"
+#include "concurrent_config.hpp"
+#include "config_manager.hpp"
 #include <iostream>
+#include <memory_resource>
 #include <string>
+#include <thread>
 #include <vector>
 
 void print_separator(const std::string& title) {
@@ -9,6 +14,32 @@ void print_separator(const std::string& title) {
     std::cout << std::string(50, '=') << "\n";
 }
 
+// Counts the requests an any makes of its memory resource
+class counting_resource : public std::pmr::memory_resource {
+public:
+    explicit counting_resource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+
+    int allocations = 0;
+    int deallocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream;
+};
+
 int main() {
     using namespace my_std;
 
@@ -157,6 +188,250 @@ int main() {
     int* empty_ptr = any_cast<int>(&empty);
     std::cout << "any_cast pointer on empty: " << (empty_ptr ? "not null" : "nullptr (expected)") << "\n";
 
+    // Test 13: Small and large values
+    print_separator("Test 13: Small and Large Values");
+    
+    struct Triple {
+        void* a;
+        void* b;
+        void* c;
+    };
+    struct MayThrowOnMove {
+        int value;
+        MayThrowOnMove(int v) : value(v) {}
+        MayThrowOnMove(const MayThrowOnMove& other) : value(other.value) {}
+    };
+    
+    int marker = 7;
+    any small = Triple{&marker, nullptr, &marker};
+    any large = std::string(100, 'x');
+    any throwing = MayThrowOnMove(5);
+    
+    any small_copy = small;
+    any small_moved = std::move(small_copy);
+    std::cout << "Moved-from small has_value: " << small_copy.has_value() << "\n";
+    std::cout << "Moved small points at marker: "
+              << (any_cast<Triple&>(small_moved).a == &marker) << "\n";
+    
+    small_moved.swap(large);
+    std::cout << "After small/large swap: " << any_cast<std::string&>(small_moved).size()
+              << " chars, Triple.c points at marker: " << (any_cast<Triple&>(large).c == &marker) << "\n";
+    
+    any throwing_copy = throwing;
+    throwing_copy = small;
+    throwing = std::move(large);
+    std::cout << "Reassigned types: " << (throwing_copy.type() == typeid(Triple)) << " "
+              << (throwing.type() == typeid(Triple)) << "\n";
+    std::cout << "Source of large move has_value: " << large.has_value() << "\n";
+
+    // Test 14: Type checks through the operations table
+    print_separator("Test 14: Type Checks");
+    
+    any same_size_int = 5;
+    any same_size_float = 5.0f;
+    std::cout << "int as float: " << (any_cast<float>(&same_size_int) ? "found" : "nullptr (expected)") << "\n";
+    std::cout << "float as int: " << (any_cast<int>(&same_size_float) ? "found" : "nullptr (expected)") << "\n";
+    const int* const_view = any_cast<const int>(&same_size_int);
+    std::cout << "int as const int: " << (const_view ? *const_view : -1) << "\n";
+    any copied_int = same_size_int;
+    std::cout << "Copy has the same type: " << (copied_int.type() == same_size_int.type()) << "\n";
+    std::cout << "Copy casts to int: " << any_cast<int>(copied_int) << "\n";
+
+    // Test 15: Values from a memory resource
+    print_separator("Test 15: Memory Resources");
+    
+    alignas(std::max_align_t) unsigned char frame_buffer[4096];
+    std::pmr::monotonic_buffer_resource frame_arena(frame_buffer, sizeof(frame_buffer),
+                                                    std::pmr::null_memory_resource());
+    counting_resource counting(&frame_arena);
+    {
+        any arena_string(std::allocator_arg, &counting, std::string("a string too long for the buffer"));
+        any arena_int(std::allocator_arg, &counting, 42);
+        std::cout << "Arena string: " << any_cast<std::string&>(arena_string) << "\n";
+        std::cout << "Arena int: " << any_cast<int>(arena_int) << "\n";
+        std::cout << "Allocations after string and int: " << counting.allocations << " (int stays inline)\n";
+        
+        any moved_string = std::move(arena_string);
+        any heap_copy = moved_string;
+        any arena_copy(std::allocator_arg, &counting, moved_string);
+        std::cout << "Allocations after move, copy and arena copy: " << counting.allocations << "\n";
+        std::cout << "Arena copy: " << any_cast<std::string&>(arena_copy) << "\n";
+        
+        any empty_copy(std::allocator_arg, &counting, any());
+        std::cout << "Arena copy of empty any has_value: " << empty_copy.has_value() << "\n";
+    }
+    std::cout << "Deallocations after scope: " << counting.deallocations << "\n";
+    frame_arena.release();
+    
+    std::pmr::unsynchronized_pool_resource pool;
+    {
+        std::vector<any> frame_events;
+        for (int frame = 0; frame < 3; ++frame) {
+            for (int i = 0; i < 100; ++i) {
+                frame_events.emplace_back(std::allocator_arg, &pool, std::string(40, char('a' + frame)));
+            }
+            std::cout << "Frame " << frame << " events: " << frame_events.size() << ", first: "
+                      << any_cast<std::string&>(frame_events.front()).substr(0, 5) << "\n";
+            frame_events.clear();
+        }
+    }
+    
+    // Test 16: any_collection
+    print_separator("Test 16: any_collection");
+    
+    any_collection items;
+    items.push_back(1);
+    items.push_back(std::string("two"));
+    items.push_back(3);
+    items.push_back(4.5);
+    const std::string five = "five";
+    items.push_back(five);
+    std::cout << "Size: " << items.size() << ", segments: " << items.segment_count() << "\n";
+    std::cout << "ints: " << items.count<int>() << ", strings: " << items.count<std::string>()
+              << ", floats: " << items.count<float>() << "\n";
+    
+    std::cout << "Insertion order:";
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (const int* x = items.get<int>(i)) {
+            std::cout << " " << *x;
+        } else if (const std::string* s = items.get<std::string>(i)) {
+            std::cout << " " << *s;
+        } else if (const double* d = items.get<double>(i)) {
+            std::cout << " " << *d;
+        }
+    }
+    std::cout << "\n";
+    std::cout << "Element 1 is a string: " << (items.type(1) == typeid(std::string)) << "\n";
+    std::cout << "Element 1 as int: " << (items.get<int>(1) ? "found" : "nullptr (expected)") << "\n";
+    std::cout << "Past the end: " << (items.get<int>(99) ? "found" : "nullptr (expected)") << "\n";
+    
+    items.for_each<int>([](int& x) { x *= 10; });
+    int total = 0;
+    const any_collection& const_items = items;
+    const_items.for_each<int>([&](int x) { total += x; });
+    std::cout << "Sum of ints after scaling: " << total << "\n";
+    std::cout << "Element 2 after scaling: " << *items.get<int>(2) << "\n";
+    
+    try {
+        items.type(99);
+    } catch (const std::out_of_range& e) {
+        std::cout << "Caught: " << e.what() << "\n";
+    }
+    items.clear();
+    std::cout << "After clear - size: " << items.size() << ", ints: " << items.count<int>() << "\n";
+    
+    // Test 17: ConfigManager with typed keys
+    print_separator("Test 17: ConfigManager");
+    
+    static constexpr config_key<int> port_key{"port"};
+    static constexpr config_key<std::string> host_key{"host"};
+    static_assert(port_key.hash() == config_hash("port"), "key hash is a constant");
+    
+    ConfigManager config;
+    const config_handle<int> port = config.resolve(port_key);
+    try {
+        config.get(port);
+    } catch (const std::runtime_error& e) {
+        std::cout << "Before loading: " << e.what() << "\n";
+    }
+    config.set(port_key, 8080);
+    config.set(host_key, "localhost");
+    config.set("retries", 3);
+    std::cout << "port (handle): " << config.get(port) << "\n";
+    std::cout << "host (key): " << config.get(host_key) << "\n";
+    std::cout << "retries (string): " << config.get<int>(std::string("retries")) << "\n";
+    std::cout << "port (string): " << config.get<int>("port") << "\n";
+    
+    for (int i = 0; i < 40; ++i) {
+        config.set("key" + std::to_string(i), i);
+    }
+    config.set(port, 9090);
+    std::cout << "Size after growth: " << config.size() << ", port (handle): " << config.get(port)
+              << ", key17: " << config.get<int>("key17") << "\n";
+    std::cout << "contains(\"host\"): " << config.contains("host") << ", contains(\"missing\"): "
+              << config.contains("missing") << "\n";
+    std::cout << "missing (default): " << config.get_or_default<int>("missing", 7)
+              << ", host as int (default): " << config.get_or_default<int>("host", -1) << "\n";
+    
+    try {
+        config.get<double>("port");
+    } catch (const bad_any_cast& e) {
+        std::cout << "Caught: " << e.what() << "\n";
+    }
+    try {
+        config.get<int>("missing");
+    } catch (const std::runtime_error& e) {
+        std::cout << "Caught: " << e.what() << "\n";
+    }
+    
+    // Test 18: ConcurrentConfigManager
+    print_separator("Test 18: ConcurrentConfigManager");
+    
+    static constexpr config_key<int> low_key{"low"};
+    static constexpr config_key<int> high_key{"high"};
+    ConcurrentConfigManager shared_config;
+    shared_config.update([](ConfigManager& next) {
+        next.set(low_key, 0);
+        next.set(high_key, 0);
+    });
+    const config_handle<int> low = shared_config.resolve(low_key);
+    const config_handle<int> high = shared_config.resolve(high_key);
+    
+    // The writer keeps high == 2 * low in every version it publishes
+    std::atomic<bool> writing{true};
+    std::vector<std::thread> reader_threads;
+    std::vector<long> torn_reads(3, 0);
+    for (size_t t = 0; t < torn_reads.size(); ++t) {
+        reader_threads.emplace_back([&, t] {
+            const ConcurrentConfigManager::reader reader = shared_config.make_reader();
+            do {
+                const ConcurrentConfigManager::snapshot view = reader.read();
+                if (view->get(high) != 2 * view->get(low)) {
+                    ++torn_reads[t];
+                }
+            } while (writing.load());
+        });
+    }
+    for (int version = 1; version <= 2000; ++version) {
+        shared_config.update([&](ConfigManager& next) {
+            next.set(low, version);
+            next.set(high, 2 * version);
+        });
+    }
+    writing = false;
+    for (std::thread& t : reader_threads) {
+        t.join();
+    }
+    long torn_total = 0;
+    for (long torn : torn_reads) {
+        torn_total += torn;
+    }
+    std::cout << "Torn reads: " << torn_total << "\n";
+    
+    const ConcurrentConfigManager::reader main_reader = shared_config.make_reader();
+    {
+        const ConcurrentConfigManager::snapshot view = main_reader.read();
+        std::cout << "Last version: low = " << view->get(low) << ", high = " << view->get(high) << "\n";
+        shared_config.set("name", std::string("after the snapshot"));
+        shared_config.reclaim();
+        std::cout << "Snapshot still sees name: " << view->contains("name")
+                  << ", replaced tables kept: " << shared_config.retired_count() << "\n";
+    }
+    shared_config.reclaim();
+    std::cout << "Replaced tables after the snapshot ends: " << shared_config.retired_count() << "\n";
+    std::cout << "New snapshot name: " << main_reader.read()->get<std::string>("name") << "\n";
+    {
+        const ConcurrentConfigManager::snapshot outer = main_reader.read();
+        {
+            const ConcurrentConfigManager::snapshot inner = main_reader.read();
+            std::cout << "Nested snapshot name: " << inner->get<std::string>("name") << "\n";
+        }
+        shared_config.set("name", std::string("after the nested snapshots"));
+        shared_config.reclaim();
+        std::cout << "Outer snapshot after the inner one ends: " << outer->get<std::string>("name")
+                  << ", replaced tables kept: " << shared_config.retired_count() << "\n";
+    }
+    
     print_separator("All Tests Completed");
     return 0;
 }
@@ -0,0 +1,173 @@
+// Benchmark of the vocabulary types against their standard counterparts:
+// project2::string_view (Project-2), optional (Project-3) and my_std::any
+// (Project-4) against std::string_view, std::optional and std::any.
+//
+// Usage: vocab_bench [iterations] [repetitions]
+//
+// Every type runs the same five operations, best of the repetitions, each
+// reported in nanoseconds and heap allocations per operation (counted by a
+// replaced global operator new), next to sizeof the type:
+//   construct  from a value: a std::string for the views, T for the others
+//   copy       copy construction
+//   move       a move construction and a move assignment back
+//   cast       getting the value out: the explicit conversion to std::string
+//              for the views, value() for optional, any_cast<T>(&a) for any
+//   compare    == between equal views and equal optionals; for any, which
+//              has no ==, type() == typeid(T)
+
+#include "any.hpp"
+#include "counting_new.hpp"
+#include "optional.hpp"
+#include "string_view.hpp"
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::uint64_t sink;
+
+// Makes the compiler build object in memory, without using its contents
+template<typename T>
+void touch(const T& object) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&object) : "memory");
+#else
+    sink = reinterpret_cast<std::uintptr_t>(&object);
+#endif
+}
+
+struct measurement {
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+template<typename F>
+measurement measure(std::size_t iterations, std::size_t repetitions, F&& run) {
+    double best = 0;
+    std::uint64_t allocs = 0;
+    for (std::size_t r = 0; r < repetitions; ++r) {
+        const std::uint64_t before = my_std::allocation_count();
+        const Clock::time_point start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            run();
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        allocs = my_std::allocation_count() - before;
+        if (r == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    return {best * 1e9 / double(iterations), double(allocs) / double(iterations)};
+}
+
+// value and other_value must be equal; cast(object) and equal(a, b) return
+// something to keep
+template<typename T, typename Value, typename Cast, typename Equal>
+void run(const char* name, const Value& value, const Value& other_value, Cast cast, Equal equal,
+         std::size_t iterations, std::size_t repetitions) {
+    const T source(value);
+    const T other(other_value);
+    T moving(value);
+
+    const measurement construct = measure(iterations, repetitions, [&] {
+        T a(value);
+        touch(a);
+    });
+    const measurement copy = measure(iterations, repetitions, [&] {
+        T a(source);
+        touch(a);
+    });
+    const measurement move = measure(iterations, repetitions, [&] {
+        T a(std::move(moving));
+        moving = std::move(a);
+        touch(moving);
+    });
+    const measurement cast_value = measure(iterations, repetitions, [&] {
+        sink = cast(source);
+    });
+    const measurement compare = measure(iterations, repetitions, [&] {
+        sink = equal(source, other);
+    });
+
+    std::cout << std::setw(24) << name << std::setw(7) << sizeof(T) << std::fixed;
+    for (const measurement& m : {construct, copy, move, cast_value, compare}) {
+        std::cout << std::setprecision(2) << std::setw(9) << m.ns_per_op << std::setprecision(1) << std::setw(5)
+                  << m.allocs_per_op;
+    }
+    std::cout << '\n';
+}
+
+const auto equal = [](const auto& a, const auto& b) { return a == b; };
+
+std::uint64_t observe(int value) {
+    return std::uint64_t(value);
+}
+
+std::uint64_t observe(const std::string& value) {
+    return value.size();
+}
+
+void views(std::size_t iterations, std::size_t repetitions) {
+    const std::string text(32, 'v');
+    const std::string other_text(32, 'v');
+    const auto to_string = [](const auto& view) { return observe(std::string(view)); };
+
+    std::cout << "string_view over 32 characters\n";
+    run<project2::string_view>("project2::string_view", text, other_text, to_string, equal, iterations,
+                               repetitions);
+    run<std::string_view>("std::string_view", text, other_text, to_string, equal, iterations, repetitions);
+}
+
+template<typename T>
+void optionals(const char* name, const T& value, std::size_t iterations, std::size_t repetitions) {
+    const auto get = [](const auto& opt) { return observe(opt.value()); };
+
+    std::cout << "optional<" << name << ">\n";
+    run<optional<T>>("optional", value, value, get, equal, iterations, repetitions);
+    run<std::optional<T>>("std::optional", value, value, get, equal, iterations, repetitions);
+}
+
+template<typename T>
+void anys(const char* name, const T& value, std::size_t iterations, std::size_t repetitions) {
+    const auto same_type = [](const auto& a, const auto&) { return a.type() == typeid(T); };
+
+    std::cout << "any holding " << name << " (" << sizeof(T) << " bytes)\n";
+    run<my_std::any>("my_std::any", value, value,
+                     [](const my_std::any& a) { return observe(*my_std::any_cast<T>(&a)); }, same_type,
+                     iterations, repetitions);
+    run<std::any>("std::any", value, value, [](const std::any& a) { return observe(*std::any_cast<T>(&a)); },
+                  same_type, iterations, repetitions);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+    if (iterations == 0 || repetitions == 0) {
+        std::cerr << "usage: vocab_bench [iterations] [repetitions]\n";
+        return 1;
+    }
+
+    std::cout << "ns/op and allocations/op\n"
+              << std::setw(24) << "" << std::setw(7) << "sizeof" << std::setw(14) << "construct" << std::setw(14)
+              << "copy" << std::setw(14) << "move" << std::setw(14) << "cast" << std::setw(14) << "compare"
+              << '\n';
+    views(iterations, repetitions);
+    optionals("int", 42, iterations, repetitions);
+    optionals("std::string", std::string("a string too long for SSO"), iterations, repetitions);
+    anys("int", 42, iterations, repetitions);
+    anys("std::string", std::string("a string too long for SSO"), iterations, repetitions);
+    return 0;
+}